@@ -0,0 +1,277 @@
+#ifndef PRODUCENTCONSUMER_QUEUEPOLICIES_H
+#define PRODUCENTCONSUMER_QUEUEPOLICIES_H
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include "WorkStealingDeque.h"
+
+// Queue policies for ThreadPool. A policy is constructed with the number of consumers and provides:
+//   bool try_push(const job_t & job, unsigned int target) - false if the queue is full, "target" is
+//                                                           the consumer the pool is going to wake
+//   size_t try_push_batch(It first, It last, unsigned int target)
+//                                                         - pushes a prefix of the range with one
+//                                                           synchronization, returns its length
+//   bool try_pop(job_t & job, unsigned int id)            - called only by consumer "id"
+//   bool empty() const                                    - only a hint under concurrent access
+// Waiting (for jobs or for free space) is up to the pool.
+
+
+// Unbounded std::list guarded by one mutex, allocates a node per job
+template<typename job_t>
+class ListQueue {
+private:
+    std::list<job_t> queue;
+    mutable std::mutex mtx_q;
+
+public:
+    explicit ListQueue(unsigned int) {}
+
+    bool try_push(const job_t & job, unsigned int) {
+        std::lock_guard<std::mutex> lck(mtx_q);
+        queue.push_back(job);
+        return true;
+    }
+
+    template<typename It>
+    size_t try_push_batch(It first, It last, unsigned int) {
+        // Nodes are allocated outside of the critical section and spliced in
+        std::list<job_t> batch(first, last);
+        const size_t pushed = batch.size();
+        std::lock_guard<std::mutex> lck(mtx_q);
+        queue.splice(queue.end(), batch);
+        return pushed;
+    }
+
+    bool try_pop(job_t & job, unsigned int) {
+        std::lock_guard<std::mutex> lck(mtx_q);
+        if (queue.empty()) return false;
+        job = queue.front();
+        queue.pop_front();
+        return true;
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lck(mtx_q);
+        return queue.empty();
+    }
+};
+
+
+// Bounded lock-free MPMC ring (D. Vyukov). Every cell carries a sequence number telling whether it is
+// ready for the producer of lap "pos" (seq == pos) or for the consumer of lap "pos" (seq == pos + 1).
+// No allocation after construction, a full ring makes try_push() fail.
+template<typename job_t, size_t capacity = 1024>
+class MPMCRingQueue {
+    static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        job_t job;
+    };
+
+    static constexpr size_t mask = capacity - 1;
+
+    std::unique_ptr<Cell[]> cells;
+
+    // Producers and consumers hammer different counters, keep them on separate cache lines
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+public:
+    explicit MPMCRingQueue(unsigned int) : cells(new Cell[capacity]) {
+        for (size_t i = 0; i < capacity; i++) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(const job_t & job, unsigned int) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell & cell = cells[pos & mask];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.job = job;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Consumer of the previous lap has not freed the cell yet
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Claims as many consecutive free cells as possible with a single CAS. A cell seen free stays
+    // free until a producer claims its position, and nobody else can claim it while our CAS succeeds.
+    template<typename It>
+    size_t try_push_batch(It first, It last, unsigned int) {
+        const size_t wanted = std::distance(first, last);
+        if (wanted == 0) return 0;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            size_t count = 0;
+            while (count < wanted && count < capacity &&
+                   cells[(pos + count) & mask].seq.load(std::memory_order_acquire) == pos + count) count++;
+            if (count == 0) {
+                const size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) return 0;
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < count; i++, ++first) {
+                    Cell & cell = cells[(pos + i) & mask];
+                    cell.job = *first;
+                    cell.seq.store(pos + i + 1, std::memory_order_release);
+                }
+                return count;
+            }
+        }
+    }
+
+    bool try_pop(job_t & job, unsigned int) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell & cell = cells[pos & mask];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    job = cell.job;
+                    cell.seq.store(pos + capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Nothing published in this cell yet
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() const {
+        return dequeue_pos.load() >= enqueue_pos.load();
+    }
+};
+
+
+// Every consumer owns a Chase-Lev deque, idle consumers steal from random victims
+template<typename job_t>
+class WorkStealingQueue {
+private:
+    struct alignas(64) Slot {
+        // Jobs owned by this consumer, only the owner pushes and pops, others steal
+        WorkStealingDeque<job_t> deque;
+
+        // Producers cannot push into a Chase-Lev deque, they drop jobs here and the owner
+        // moves them into its deque in one go
+        mutable std::mutex mtx_inbox;
+        std::vector<job_t> inbox;
+        // Second buffer swapped with the inbox, only the owner touches it. It is cleared after
+        // the move, so both buffers keep their capacity and pushes do not allocate under the lock
+        std::vector<job_t> arrived;
+
+        // Victim selection of the owner, so that thieves do not gang up on one consumer
+        std::minstd_rand rnd;
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    bool steal_from(unsigned int victim, job_t & job);
+
+public:
+    explicit WorkStealingQueue(unsigned int num_consumers);
+
+    bool try_push(const job_t & job, unsigned int target);
+    template<typename It>
+    size_t try_push_batch(It first, It last, unsigned int target);
+    bool try_pop(job_t & job, unsigned int id);
+    bool empty() const;
+};
+
+
+template<typename job_t>
+WorkStealingQueue<job_t>::WorkStealingQueue(const unsigned int num_consumers) {
+    for (unsigned int i = 0; i < num_consumers; i++) {
+        slots.emplace_back(new Slot());
+        slots.back()->rnd.seed(i + 1);
+    }
+}
+
+template<typename job_t>
+bool WorkStealingQueue<job_t>::try_push(const job_t & job, const unsigned int target) {
+    Slot & slot = *slots[target];
+    std::lock_guard<std::mutex> lck(slot.mtx_inbox);
+    slot.inbox.push_back(job);
+    return true;
+}
+
+template<typename job_t>
+template<typename It>
+size_t WorkStealingQueue<job_t>::try_push_batch(It first, It last, const unsigned int target) {
+    // The whole batch goes to one owner, idle consumers spread it by stealing
+    Slot & slot = *slots[target];
+    std::lock_guard<std::mutex> lck(slot.mtx_inbox);
+    const size_t before = slot.inbox.size();
+    slot.inbox.insert(slot.inbox.end(), first, last);
+    return slot.inbox.size() - before;
+}
+
+template<typename job_t>
+bool WorkStealingQueue<job_t>::try_pop(job_t & job, const unsigned int id) {
+    Slot & own = *slots[id];
+    if (own.deque.pop(job)) return true;
+
+    // Move everything producers gave us into our deque, newest first so that we pop
+    // the oldest job first and thieves take the newest ones
+    {
+        std::lock_guard<std::mutex> lck(own.mtx_inbox);
+        own.arrived.swap(own.inbox);
+    }
+    for (auto it = own.arrived.rbegin(); it != own.arrived.rend(); ++it) own.deque.push(*it);
+    own.arrived.clear();
+    if (own.deque.pop(job)) return true;
+
+    const unsigned int n = slots.size();
+    const unsigned int start = own.rnd() % n;
+    for (unsigned int i = 0; i < n; i++) {
+        const unsigned int victim = (start + i) % n;
+        if (victim != id && steal_from(victim, job)) return true;
+    }
+    return false;
+}
+
+template<typename job_t>
+bool WorkStealingQueue<job_t>::steal_from(const unsigned int victim, job_t & job) {
+    Slot & slot = *slots[victim];
+    if (slot.deque.steal(job)) return true;
+
+    // Victim is busy and has not moved its inbox yet
+    std::lock_guard<std::mutex> lck(slot.mtx_inbox);
+    if (slot.inbox.empty()) return false;
+    job = slot.inbox.back();
+    slot.inbox.pop_back();
+    return true;
+}
+
+template<typename job_t>
+bool WorkStealingQueue<job_t>::empty() const {
+    for (const auto & slot : slots) {
+        if (!slot->deque.empty()) return false;
+        std::lock_guard<std::mutex> lck(slot->mtx_inbox);
+        if (!slot->inbox.empty()) return false;
+    }
+    return true;
+}
+
+#endif //PRODUCENTCONSUMER_QUEUEPOLICIES_H
@@ -121,17 +121,79 @@
 #ifndef PRODUCENTCONSUMER_THREADPOOL_H
 #define PRODUCENTCONSUMER_THREADPOOL_H
 
-#include <list>
+#include <cmath>
+#include <ctime>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
 #include <thread>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <condition_variable>
+#include "QueuePolicies.h"
 
-template<typename job_t, typename worker_t>
+// CPU time consumed by the calling thread, 0 where the platform cannot tell
+static inline uint64_t thread_cpu_ns() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+    return 0;
+}
+
+// queue_t decides how jobs get from producers to consumers, see QueuePolicies.h.
+// Every job_t value is a valid job, the pool is stopped with shutdown().
+// With min_threads < max_threads a controller thread resizes the pool: it grows while jobs wait
+// and nobody is idle, up to what the measured blocking ratio (1 - CPU time / wall time of the
+// jobs) suggests the cores can absorb, and it shrinks again when consumers stay idle.
+template<typename job_t, typename worker_t, template<typename> class queue_t = ListQueue>
 class ThreadPool {
 private:
+    // Completion state of one process_batch() call, freed by the consumer finishing its last job
+    struct Batch {
+        explicit Batch(const size_t size) : remaining(size) {}
+        std::atomic<size_t> remaining;
+        std::promise<void> done;
+    };
+
+    // What actually travels through the queue
+    struct Task {
+        job_t job;
+        Batch * batch;
+    };
+
+    // Parking spot of one consumer, lets a producer wake exactly this consumer
+    struct alignas(64) Parker {
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool wakeup = false;
+        std::atomic<bool> sleeping{false};
+        // Jobs finished by this consumer, written only by the owner so it never bounces between cores
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> started{0};
+        // Wall and CPU time of the sampled jobs
+        std::atomic<uint64_t> wall_ns{0};
+        std::atomic<uint64_t> cpu_ns{0};
+        // A thread runs for this id, guarded by mtx_resize
+        bool alive = false;
+    };
+
+    // Every SAMPLE_EVERY-th job of a consumer is timed in adaptive mode
+    static constexpr uint64_t SAMPLE_EVERY = 8;
+    // Idle controller ticks before the pool gives back a consumer
+    static constexpr unsigned int SHRINK_AFTER_TICKS = 3;
+    // Longest drain() sleep without a notification
+    static constexpr std::chrono::milliseconds DRAIN_RECHECK{1};
+
     // Fronta uloh
-    std::list<job_t> queue;
+    queue_t<Task> queue;
 
     // Vlakna konzumentu zpracovavajicich ulohy
     std::vector<std::thread> threads;
@@ -139,22 +201,101 @@ private:
     // Funkce, kterou maji konzumenti vykonavat
     const worker_t & worker;
 
-    // Mutex for accessing queue
-    std::mutex mtx_q;
+    std::vector<std::unique_ptr<Parker>> parkers;
+    // Round robin target for process()
+    std::atomic<unsigned int> next_consumer{0};
+    // Number of parked consumers, lets process() skip the wakeup scan
+    std::atomic<unsigned int> idle{0};
+    // Set by shutdown(), consumers leave once the queue is empty and no producer is in the middle of a push
+    std::atomic<bool> stopping{false};
+    // Producers past their "stopping" check whose push has not finished yet
+    std::atomic<unsigned int> producers{0};
+    std::atomic<uint64_t> submitted{0};
+
+    // Producers blocked on a full queue (bounded policies only)
+    std::mutex mtx_space;
+    std::condition_variable cv_space;
+    std::atomic<unsigned int> waiting_producers{0};
 
-    // Conditional variable to avoid busy waiting
-    std::condition_variable cv;
+    // Callers blocked in drain()
+    std::mutex mtx_drain;
+    std::condition_variable cv_drain;
+    std::atomic<unsigned int> draining{0};
+
+    // Pool size, consumers with id >= target_size retire once they run out of work
+    const unsigned int min_threads;
+    const unsigned int max_threads;
+    const std::chrono::milliseconds period;
+    std::atomic<unsigned int> target_size;
+    std::atomic<unsigned int> alive_count{0};
+    std::mutex mtx_resize;
+    std::condition_variable cv_control;
+    std::thread controller;
+
+    // Registers a producer for the duration of one process()/process_batch() call, throws after shutdown()
+    class Submission {
+    public:
+        Submission(ThreadPool & pool, const char * caller);
+        ~Submission();
+    private:
+        ThreadPool & pool;
+        void leave();
+    };
+
+    void loop(unsigned int id);
+    void run(const Task & task, Parker & own);
+    void finish(const Task & task, Parker & own);
+    bool retire(unsigned int id);
+    void control();
+    void resize(unsigned int size);
+    void start(unsigned int id);
+    void park(unsigned int id);
+    void wake(unsigned int id);
+    void wake_idle(unsigned int preferred, unsigned int count);
+    void notify_drain();
+    uint64_t completed() const;
+    template<typename It>
+    void push_blocking(It first, It last, unsigned int target);
 
 public:
     ThreadPool(const unsigned int num_threads, const worker_t & worker);
+    // Adaptive pool, starts with min_threads consumers and re-evaluates its size every "period"
+    ThreadPool(const unsigned int min_threads, const unsigned int max_threads, const worker_t & worker,
+               const std::chrono::milliseconds period = std::chrono::milliseconds(10));
+    ~ThreadPool();
+
     void process(const job_t job);
+    // Enqueues [first, last) with a single synchronization, the future is ready once all of them finished
+    template<typename Iter>
+    std::future<void> process_batch(Iter first, Iter last);
+
+    // Blocks until as many jobs as were submitted before the call have finished, the pool keeps running.
+    // Jobs submitted concurrently do not extend the wait.
+    void drain();
+    // Lets the consumers finish the queued jobs and joins them, process() throws afterwards
+    void shutdown();
+    // Same as shutdown(). There is no terminating job any more, so waiting without stopping would never return
     void join();
 
+    // Counters for monitoring, each is a snapshot that may be stale by the time it is returned
+    unsigned int size() const { return alive_count.load(); }
+    unsigned int idle_workers() const { return idle.load(); }
+    // Jobs submitted but not yet picked up by a consumer
+    uint64_t queue_depth() const;
+    uint64_t completed_jobs() const { return completed(); }
+
 };
 
 
-template<typename job_t, typename worker_t>
-ThreadPool<job_t, worker_t>::ThreadPool(const unsigned int num_threads, const worker_t &worker) : worker(worker) {
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+ThreadPool<job_t, worker_t, queue_t>::ThreadPool(const unsigned int num_threads, const worker_t &worker)
+        : ThreadPool(num_threads, num_threads, worker) {}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+ThreadPool<job_t, worker_t, queue_t>::ThreadPool(const unsigned int min_threads, const unsigned int max_threads,
+                                                 const worker_t &worker, const std::chrono::milliseconds period)
+        : queue(max_threads), threads(max_threads), worker(worker), min_threads(min_threads),
+          max_threads(max_threads), period(period), target_size(min_threads) {
     // Zde vytvorte "num_threads" vlaken konzumentu:
     //   - Po spusteni bude vlakno kontrolovat, zda je ve fronte uloh "queue" nejaka
     //     uloha ke zpracovani, tj., fronta neni prazdna - !queue.empty()
@@ -164,40 +305,16 @@ ThreadPool<job_t, worker_t>::ThreadPool(const unsigned int num_threads, const wo
     //   - Vlakno se ukonci pokud uloha ke zpracovani je 0
     //   - Vytvorena vlakna vlozte do pole "threads"
 
-    // We should pop ALL zeros from the queue (producent adds `num_threads` zeros to queue as END OF WORK)
-
-    for(int i = 0; i < num_threads; i++) {
-
-        threads.push_back(std::thread([&]() {
-            while (true) {
-                job_t job = -1;
-                std::unique_lock<std::mutex> lck(mtx_q); // equal mtx_q.lock()
-
-                if (!queue.empty()) {
-                    job = queue.front(); // Read the job from front of queue
-                    queue.pop_front(); // Pop job that we read
-                }
-
-                // Check if end of work
-                if(job == 0){
-                    lck.unlock();
-                    break;
-                }
-
-                // Queue is empty, wait until full (cv.notification)
-                if(job == -1){
-                    cv.wait(lck);
-                    lck.unlock();
-                    continue;
-                }
-
-                lck.unlock();
-                cv.notify_all();
+    if (min_threads == 0 || min_threads > max_threads) throw std::invalid_argument("ThreadPool needs 0 < min_threads <= max_threads");
 
-                worker(job); // Working...
-            }
-        }));
+    // Parkers must exist before any consumer can be woken
+    for (unsigned int i = 0; i < max_threads; i++) parkers.emplace_back(new Parker());
+    {
+        std::lock_guard<std::mutex> lck(mtx_resize);
+        for (unsigned int i = 0; i < min_threads; i++) start(i);
     }
+    if (min_threads < max_threads) controller = std::thread([this]() { control(); });
+
     // Tento kod nesplnuje zadani z nekolika duvodu:
     //   - Spousti pouze jedno vlakno konzumenta. Pokud vykonani uloh pomoci worker(task)
     //     trva delsi dobu a konzument nestiha ulohy zpracovavat, zacnou se nam ulohy ve
@@ -215,27 +332,342 @@ ThreadPool<job_t, worker_t>::ThreadPool(const unsigned int num_threads, const wo
     // pouze jedna uloha - a prisli bychom o vyhody paralelizace.
 }
 
-template<typename job_t, typename worker_t>
-void ThreadPool<job_t, worker_t>::process(const job_t job) {
-    // Bezpecne vlozte ulohu "job" do fronty uloh "queue"
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+ThreadPool<job_t, worker_t, queue_t>::~ThreadPool() {
+    shutdown();
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::loop(const unsigned int id) {
+    Parker & own = *parkers[id];
+    while (true) {
+        Task task;
+        if (queue.try_pop(task, id)) {
+            // A slot got free, tell a blocked producer
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiting_producers.load() > 0) {
+                std::lock_guard<std::mutex> lck(mtx_space);
+                cv_space.notify_one();
+            }
 
-    // Locking queue to access the queue
-    mtx_q.lock();
+            run(task, own);
+            continue;
+        }
 
-    // add job
-    queue.push_back(job);
+        // Empty check also covers ring cells that are claimed but not yet published. A producer that got
+        // past its "stopping" check is still counted in "producers" until its push is visible.
+        if (stopping.load() && producers.load() == 0 && queue.empty()) break;
 
-    // Unlocking queue
-    mtx_q.unlock();
+        if (id >= target_size.load() && retire(id)) break;
+
+        park(id);
+    }
+    notify_drain();
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::run(const Task & task, Parker & own) {
+    const uint64_t started = own.started.load(std::memory_order_relaxed);
+    own.started.store(started + 1, std::memory_order_release);
+
+    if (min_threads == max_threads || started % SAMPLE_EVERY != 0) {
+        worker(task.job); // Working...
+        finish(task, own);
+        return;
+    }
+
+    const auto wall_begin = std::chrono::steady_clock::now();
+    const uint64_t cpu_begin = thread_cpu_ns();
+    worker(task.job); // Working...
+    const uint64_t cpu = thread_cpu_ns() - cpu_begin;
+    const uint64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_begin).count();
+    own.wall_ns.store(own.wall_ns.load(std::memory_order_relaxed) + wall, std::memory_order_relaxed);
+    own.cpu_ns.store(own.cpu_ns.load(std::memory_order_relaxed) + cpu, std::memory_order_relaxed);
+    finish(task, own);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::finish(const Task & task, Parker & own) {
+    if (task.batch != nullptr && task.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        task.batch->done.set_value();
+        delete task.batch;
+    }
+    own.completed.store(own.completed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    // Consumers that never run out of work would otherwise not wake a drain() until they park
+    if (draining.load(std::memory_order_relaxed) > 0) notify_drain();
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::park(const unsigned int id) {
+    Parker & own = *parkers[id];
+
+    // Announce ourselves first and look for work afterwards. A producer publishes a job
+    // before it checks "sleeping", so (thanks to the fences) one of us sees the other.
+    own.sleeping.store(true);
+    idle.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Running out of work is the only moment a drain() can be satisfied
+    notify_drain();
+
+    if (queue.empty() && (!stopping.load() || producers.load() > 0) && id < target_size.load()) {
+        std::unique_lock<std::mutex> lck(own.mtx);
+        own.cv.wait(lck, [&own]() { return own.wakeup; });
+        own.wakeup = false;
+    }
+
+    idle.fetch_sub(1);
+    own.sleeping.store(false);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+ThreadPool<job_t, worker_t, queue_t>::Submission::Submission(ThreadPool & pool, const char * caller) : pool(pool) {
+    // Announce first and check afterwards, shutdown() sets "stopping" first and consumers check "producers"
+    // afterwards, so either we see the shutdown or the consumers wait for our push
+    pool.producers.fetch_add(1);
+    if (pool.stopping.load()) {
+        leave();
+        throw std::logic_error(std::string(caller) + " after shutdown()");
+    }
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+ThreadPool<job_t, worker_t, queue_t>::Submission::~Submission() {
+    leave();
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::Submission::leave() {
+    pool.producers.fetch_sub(1);
+    // Consumers parked during shutdown() are waiting for the last producer
+    if (pool.stopping.load()) {
+        for (unsigned int i = 0; i < pool.parkers.size(); i++) pool.wake(i);
+    }
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::wake(const unsigned int id) {
+    Parker & parker = *parkers[id];
+    {
+        std::lock_guard<std::mutex> lck(parker.mtx);
+        parker.wakeup = true;
+    }
+    parker.cv.notify_one();
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::wake_idle(const unsigned int preferred, unsigned int count) {
+    if (parkers[preferred]->sleeping.load()) {
+        wake(preferred);
+        if (--count == 0) return;
+    }
+    // Preferred consumer is busy, wake single parked ones instead of everybody
+    const unsigned int n = parkers.size();
+    for (unsigned int i = 1; i < n && count > 0 && idle.load() > 0; i++) {
+        const unsigned int id = (preferred + i) % n;
+        if (parkers[id]->sleeping.load()) {
+            wake(id);
+            count--;
+        }
+    }
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::notify_drain() {
+    if (draining.load() > 0) {
+        std::lock_guard<std::mutex> lck(mtx_drain);
+        cv_drain.notify_all();
+    }
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+bool ThreadPool<job_t, worker_t, queue_t>::retire(const unsigned int id) {
+    // Controller may have grown the pool again in the meantime
+    std::lock_guard<std::mutex> lck(mtx_resize);
+    if (id < target_size.load()) return false;
+    parkers[id]->alive = false;
+    alive_count.fetch_sub(1);
+    return true;
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::start(const unsigned int id) {
+    // Called with mtx_resize held
+    if (parkers[id]->alive) return;
+    // Previous consumer with this id has retired, it only needs to be reaped
+    if (threads[id].joinable()) threads[id].join();
+    parkers[id]->alive = true;
+    alive_count.fetch_add(1);
+    threads[id] = std::thread([this, id]() { loop(id); });
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::resize(const unsigned int size) {
+    // Called with mtx_resize held
+    const unsigned int old_size = target_size.exchange(size);
+    for (unsigned int id = old_size; id < size; id++) start(id);
+    // Parked consumers would never notice they should retire
+    for (unsigned int id = size; id < old_size; id++) wake(id);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::control() {
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t last_wall = 0, last_cpu = 0;
+    double blocking = 0;
+    unsigned int idle_ticks = 0;
+
+    std::unique_lock<std::mutex> lck(mtx_resize);
+    while (!cv_control.wait_for(lck, period, [this]() { return stopping.load(); })) {
+        uint64_t wall = 0, cpu = 0;
+        for (const auto & parker : parkers) {
+            wall += parker->wall_ns.load(std::memory_order_relaxed);
+            cpu += parker->cpu_ns.load(std::memory_order_relaxed);
+        }
+        // Keep the previous estimate if no sampled job finished or CPU time is not available
+        if (wall > last_wall && cpu > last_cpu) {
+            blocking = 1.0 - std::min(1.0, static_cast<double>(cpu - last_cpu) / (wall - last_wall));
+        }
+        last_wall = wall;
+        last_cpu = cpu;
+
+        // A job blocked for a fraction b of its time leaves room for 1 / (1 - b) jobs per core
+        const double wanted = std::ceil(cores / std::max(1.0 - blocking, 1.0 / max_threads));
+        const unsigned int desired = std::max(min_threads, std::min(max_threads, static_cast<unsigned int>(wanted)));
+
+        const unsigned int size = target_size.load();
+        const uint64_t depth = queue_depth();
+        const unsigned int idle_now = idle.load();
+
+        if (depth > 0 && idle_now == 0 && size < desired) {
+            resize(static_cast<unsigned int>(std::min<uint64_t>(desired, size + depth)));
+            idle_ticks = 0;
+        } else if (depth == 0 && idle_now > 0 && size > min_threads) {
+            if (++idle_ticks >= SHRINK_AFTER_TICKS) {
+                resize(size - 1);
+                idle_ticks = 0;
+            }
+        } else {
+            idle_ticks = 0;
+        }
+    }
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+uint64_t ThreadPool<job_t, worker_t, queue_t>::queue_depth() const {
+    uint64_t started = 0;
+    for (const auto & parker : parkers) started += parker->started.load(std::memory_order_acquire);
+    const uint64_t total = submitted.load();
+    return total > started ? total - started : 0;
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+uint64_t ThreadPool<job_t, worker_t, queue_t>::completed() const {
+    uint64_t sum = 0;
+    for (const auto & parker : parkers) sum += parker->completed.load(std::memory_order_acquire);
+    return sum;
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+template<typename It>
+void ThreadPool<job_t, worker_t, queue_t>::push_blocking(It first, It last, const unsigned int target) {
+    size_t pushed = queue.try_push_batch(first, last, target);
+    first += pushed;
+    if (first == last) return;
+
+    // Queue is full, wait until a consumer takes something. The consumer checks
+    // "waiting_producers" after its pop, we retry after announcing ourselves.
+    std::unique_lock<std::mutex> lck(mtx_space);
+    waiting_producers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (true) {
+        // Consumers may all be parked, let them start on what already fits
+        if (pushed > 0) wake_idle(target, pushed);
+        pushed = queue.try_push_batch(first, last, target);
+        first += pushed;
+        if (first == last) break;
+        if (pushed == 0) cv_space.wait(lck);
+    }
+    waiting_producers.fetch_sub(1);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::process(const job_t job) {
+    // Bezpecne vlozte ulohu "job" do fronty uloh "queue"
+    const Submission submission(*this, "ThreadPool::process()");
+
+    const unsigned int target = next_consumer.fetch_add(1, std::memory_order_relaxed) % target_size.load();
+    submitted.fetch_add(1);
+    const Task task = {job, nullptr};
+    if (!queue.try_push(task, target)) push_blocking(&task, &task + 1, target);
 
     // Notify about adding job to the queue
-    cv.notify_all();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake_idle(target, 1);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+template<typename Iter>
+std::future<void> ThreadPool<job_t, worker_t, queue_t>::process_batch(Iter first, Iter last) {
+    const Submission submission(*this, "ThreadPool::process_batch()");
+
+    const size_t size = std::distance(first, last);
+    Batch * batch = new Batch(size);
+    std::future<void> done = batch->done.get_future();
+    if (size == 0) {
+        batch->done.set_value();
+        delete batch;
+        return done;
+    }
+
+    std::vector<Task> tasks;
+    tasks.reserve(size);
+    for (; first != last; ++first) tasks.push_back({*first, batch});
+
+    const unsigned int target = next_consumer.fetch_add(1, std::memory_order_relaxed) % target_size.load();
+    submitted.fetch_add(size);
+    push_blocking(tasks.begin(), tasks.end(), target);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake_idle(target, size < parkers.size() ? size : parkers.size());
+    return done;
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::drain() {
+    // Target is fixed on entry, otherwise producers that keep submitting could keep us waiting forever
+    const uint64_t target = submitted.load();
+
+    // Consumers look at "draining" after they run out of work, we check the counters after announcing
+    std::unique_lock<std::mutex> lck(mtx_drain);
+    draining.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Without a fence per job, finish() may miss our announcement, the timeout bounds that window
+    while (completed() < target) cv_drain.wait_for(lck, DRAIN_RECHECK);
+    draining.fetch_sub(1);
+}
+
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::shutdown() {
+    if (!stopping.exchange(true)) {
+        {
+            std::lock_guard<std::mutex> lck(mtx_resize);
+        }
+        cv_control.notify_all();
+        if (controller.joinable()) controller.join();
+        for (unsigned int i = 0; i < parkers.size(); i++) wake(i);
+    }
+    for (unsigned int i = 0; i < threads.size(); i++) {
+        if (threads[i].joinable()) threads[i].join();
+    }
 }
 
 // Tato metoda nam umozni volajici funkci v main.cpp pockat na vsechna spustena vlakna konzumentu
-template<typename job_t, typename worker_t>
-void ThreadPool<job_t, worker_t>::join() {
-    for(unsigned int i = 0 ; i < threads.size() ; i++) threads[i].join();
+// (konzumenti skonci az po shutdown(), proto ho join() zavola sam)
+template<typename job_t, typename worker_t, template<typename> class queue_t>
+void ThreadPool<job_t, worker_t, queue_t>::join() {
+    shutdown();
 }
 
 #endif //PRODUCENTCONSUMER_THREADPOOL_H
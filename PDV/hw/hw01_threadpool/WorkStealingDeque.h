@@ -0,0 +1,144 @@
+#ifndef PRODUCENTCONSUMER_WORKSTEALINGDEQUE_H
+#define PRODUCENTCONSUMER_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Chase-Lev work-stealing deque (memory orderings follow Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). Only the owning thread may call push() and pop(),
+// which work on the bottom end. Any other thread may steal() from the top end.
+template<typename job_t>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<job_t>::value, "Jobs are copied in and out of atomic words");
+
+private:
+    // Circular array, capacity is always a power of two. A thief may read a slot the owner is just
+    // overwriting (its CAS on top fails afterwards and the value is dropped), so slots are made of
+    // relaxed atomic words instead of plain job_t. That also avoids 16 byte atomics for larger jobs.
+    struct Buffer {
+        static constexpr size_t words = (sizeof(job_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        explicit Buffer(const size_t capacity) : mask(capacity - 1), slots(new std::atomic<uint64_t>[capacity * words]) {}
+
+        size_t capacity() const { return mask + 1; }
+
+        job_t get(const int64_t i) const {
+            uint64_t raw[words];
+            for (size_t w = 0; w < words; w++) raw[w] = slots[(i & mask) * words + w].load(std::memory_order_relaxed);
+            job_t job;
+            std::memcpy(&job, raw, sizeof(job_t));
+            return job;
+        }
+
+        void put(const int64_t i, const job_t job) {
+            uint64_t raw[words] = {};
+            std::memcpy(raw, &job, sizeof(job_t));
+            for (size_t w = 0; w < words; w++) slots[(i & mask) * words + w].store(raw[w], std::memory_order_relaxed);
+        }
+
+        const size_t mask;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    };
+
+    // Top is written by thieves and bottom by the owner, keep them on different cache lines
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Buffer *> buffer;
+
+    // Buffers replaced by grow(), a thief may still be reading from them, so they die with the deque
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    Buffer * grow(Buffer * old, int64_t t, int64_t b);
+
+public:
+    explicit WorkStealingDeque(size_t capacity = 256);
+
+    void push(job_t job);
+    bool pop(job_t & job);
+    bool steal(job_t & job);
+
+    // Only a hint when called concurrently with the other operations
+    bool empty() const;
+};
+
+
+template<typename job_t>
+WorkStealingDeque<job_t>::WorkStealingDeque(size_t capacity) {
+    size_t pow2 = 1;
+    while (pow2 < capacity) pow2 <<= 1;
+    buffers.emplace_back(new Buffer(pow2));
+    buffer.store(buffers.back().get(), std::memory_order_relaxed);
+}
+
+template<typename job_t>
+typename WorkStealingDeque<job_t>::Buffer * WorkStealingDeque<job_t>::grow(Buffer * old, int64_t t, int64_t b) {
+    buffers.emplace_back(new Buffer(old->capacity() * 2));
+    Buffer * bigger = buffers.back().get();
+    for (int64_t i = t; i < b; i++) bigger->put(i, old->get(i));
+    buffer.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+template<typename job_t>
+void WorkStealingDeque<job_t>::push(const job_t job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    Buffer * buf = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > static_cast<int64_t>(buf->capacity()) - 1) buf = grow(buf, t, b);
+
+    buf->put(b, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template<typename job_t>
+bool WorkStealingDeque<job_t>::pop(job_t & job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer * buf = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    // Deque was empty
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    job = buf->get(b);
+    if (t == b) {
+        // Last job, race against thieves for it
+        const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename job_t>
+bool WorkStealingDeque<job_t>::steal(job_t & job) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) return false;
+
+    Buffer * buf = buffer.load(std::memory_order_acquire);
+    job = buf->get(t);
+    // Lost against the owner or another thief
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+template<typename job_t>
+bool WorkStealingDeque<job_t>::empty() const {
+    const int64_t t = top.load(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_seq_cst);
+    return b <= t;
+}
+
+#endif //PRODUCENTCONSUMER_WORKSTEALINGDEQUE_H
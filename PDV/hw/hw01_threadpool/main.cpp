@@ -1,11 +1,20 @@
 #include <iostream>
 #include <list>
 #include <random>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
 #include "ThreadPool.h"
 
 // Nastaveni poctu konzumentu a producentu
 const unsigned int NWORKERS = 2;
 const unsigned int NPRODUCERS = 2;
+// Pool grows up to MAX_WORKERS consumers while jobs wait (workers mostly sleep)
+const unsigned int MAX_WORKERS = 16;
 
 // Nastaveni poctu uloh pro kazdeho producenta a rozsah,
 // ze ktereho se budou ulohy generovat
@@ -23,7 +32,273 @@ const bool VERBOSE = true;
 // Mutex pro vypisy na stdout
 std::mutex cout_mu;
 
-int main() {
+// Benchmark (./threadpool.bin bench): producers push jobs as fast as they can and the
+// workers do a short Collatz computation without sleeping, so the queue itself is measured
+const std::vector<unsigned int> BENCH_PRODUCERS = {1, 4, 16, 64};
+const std::vector<unsigned int> BENCH_WORKERS = {1, 4, 16, 64};
+const unsigned int BENCH_JOBS = 400000;
+// 1 submits with process(), anything larger with process_batch()
+const std::vector<unsigned int> BENCH_BATCH_SIZES = {1, 64};
+const unsigned int BENCH_MAX_DATA = 1000;
+
+// One record per processed job
+struct JobSample {
+    uint64_t latency_ns; // from process() to the start of worker(job)
+    uint64_t steps;      // keeps the Collatz loop from being optimized away
+};
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Resident set size in kB (Linux only, 0 elsewhere)
+static long rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::stol(line.substr(6));
+    }
+    return 0;
+}
+
+// Jobs are enqueue timestamps (never 0), the Collatz input is derived from them
+template<template<typename> class queue_t>
+void run_benchmark(const char * name, const unsigned int batch_size, const unsigned int nproducers,
+                   const unsigned int nworkers) {
+    const unsigned int jobs_per_producer = BENCH_JOBS / nproducers;
+    const size_t njobs = static_cast<size_t>(nproducers) * jobs_per_producer;
+    std::vector<JobSample> samples(njobs);
+    std::atomic<size_t> processed{0};
+
+    const auto worker = [&samples, &processed](unsigned long long enqueued_at) {
+        const uint64_t started_at = now_ns();
+        unsigned long long data = enqueued_at % BENCH_MAX_DATA + 1;
+        uint64_t steps = 0;
+        while (data > 1) {
+            steps++;
+            if (data % 2) data = 3 * data + 1;
+            else data /= 2;
+        }
+        samples[processed.fetch_add(1, std::memory_order_relaxed)] = {started_at - enqueued_at, steps};
+    };
+
+    // Sample RSS while the pool runs, an unbounded queue shows up as a peak above the baseline
+    const long rss_before = rss_kb();
+    std::atomic<bool> running{true};
+    long rss_peak = rss_before;
+    std::thread monitor([&running, &rss_peak]() {
+        while (running.load()) {
+            rss_peak = std::max(rss_peak, rss_kb());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        ThreadPool<unsigned long long, decltype(worker), queue_t> pool(nworkers, worker);
+
+        std::vector<std::thread> producers;
+        for (unsigned int i = 0; i < nproducers; i++) {
+            producers.emplace_back([&pool, jobs_per_producer, batch_size]() {
+                if (batch_size == 1) {
+                    for (unsigned int j = 0; j < jobs_per_producer; j++) pool.process(now_ns());
+                    return;
+                }
+                std::vector<unsigned long long> batch;
+                for (unsigned int j = 0; j < jobs_per_producer; j += batch_size) {
+                    batch.clear();
+                    for (unsigned int k = j; k < jobs_per_producer && k < j + batch_size; k++) batch.push_back(now_ns());
+                    pool.process_batch(batch.begin(), batch.end());
+                }
+            });
+        }
+        for (auto & producer : producers) producer.join();
+        pool.shutdown();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    running.store(false);
+    monitor.join();
+
+    std::vector<uint64_t> latencies(njobs);
+    for (size_t i = 0; i < njobs; i++) latencies[i] = samples[i].latency_ns;
+    const size_t p99 = njobs * 99 / 100;
+    std::nth_element(latencies.begin(), latencies.begin() + p99, latencies.end());
+
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    printf("%-14s %5u %9u %7u %14.0f %14.1f %14.1f\n", name, batch_size, nproducers, nworkers, njobs / seconds,
+           latencies[p99] / 1000.0, (rss_peak - rss_before) / 1024.0);
+}
+
+void run_benchmarks() {
+    printf("%-14s %5s %9s %7s %14s %14s %14s\n", "queue", "batch", "producers", "workers", "jobs/s",
+           "p99 wait [us]", "peak RSS [MB]");
+    for (const unsigned int batch_size : BENCH_BATCH_SIZES) {
+        for (const unsigned int nproducers : BENCH_PRODUCERS) {
+            for (const unsigned int nworkers : BENCH_WORKERS) {
+                run_benchmark<ListQueue>("list", batch_size, nproducers, nworkers);
+                run_benchmark<MPMCRingQueue>("mpmc-ring", batch_size, nproducers, nworkers);
+                run_benchmark<WorkStealingQueue>("work-stealing", batch_size, nproducers, nworkers);
+            }
+        }
+    }
+}
+
+// Checks (./threadpool.bin check) for drain(), shutdown() and join() racing with producers
+const unsigned int CHECK_PRODUCERS = 4;
+const unsigned int CHECK_WORKERS = 2;
+const unsigned int CHECK_DRAINS = 50;
+const unsigned int CHECK_SHUTDOWNS = 200;
+const std::chrono::seconds CHECK_TIMEOUT(10);
+// Producers keep about this many jobs waiting, so the consumers never run out of work but the backlog stays bounded
+const uint64_t CHECK_BACKLOG = 2000;
+const std::chrono::microseconds CHECK_PRODUCER_PAUSE(50);
+// Collatz inputs per job, a few microseconds of work so that the backlog outlasts a producer pause
+const unsigned int CHECK_WORK = 16;
+std::atomic<uint64_t> check_steps{0};
+
+// Jobs have value 1, "executed" ends up as the number of finished jobs
+static void check_job(std::atomic<uint64_t> & executed, unsigned long long job) {
+    uint64_t steps = 0;
+    for (unsigned long long i = 1; i <= CHECK_WORK; i++) {
+        for (unsigned long long data = 27 * i; data > 1; steps++) {
+            if (data % 2) data = 3 * data + 1;
+            else data /= 2;
+        }
+    }
+    check_steps.fetch_add(steps, std::memory_order_relaxed);
+    executed.fetch_add(job);
+}
+
+// Runs "call" and gives up on the whole process if it blocks for longer than CHECK_TIMEOUT
+template<typename F>
+bool finishes_in_time(F call) {
+    std::future<void> done = std::async(std::launch::async, call);
+    if (done.wait_for(CHECK_TIMEOUT) == std::future_status::ready) return true;
+    printf("blocked for more than %lld s\n", static_cast<long long>(CHECK_TIMEOUT.count()));
+    std::fflush(stdout);
+    std::_Exit(1);
+}
+
+// Producers submit jobs of value 1, process() and batches of 8 alternate
+template<typename pool_t>
+void produce(pool_t & pool, std::atomic<bool> & running, std::atomic<uint64_t> & accepted,
+             const std::atomic<uint64_t> & executed, std::vector<std::future<void>> & batches) {
+    std::vector<unsigned long long> batch(8, 1);
+    try {
+        for (unsigned long long i = 0; running.load(); i++) {
+            if (i % 2) {
+                pool.process(1);
+                accepted.fetch_add(1);
+            } else {
+                batches.push_back(pool.process_batch(batch.begin(), batch.end()));
+                accepted.fetch_add(batch.size());
+            }
+            while (running.load() && accepted.load() - executed.load() > CHECK_BACKLOG) {
+                std::this_thread::sleep_for(CHECK_PRODUCER_PAUSE);
+            }
+        }
+    } catch (const std::logic_error &) {
+        // shutdown() came first, this call did not enqueue anything
+    }
+}
+
+// drain() must return while producers keep submitting and cover everything accepted before it
+template<template<typename> class queue_t>
+bool check_drain(const char * name) {
+    std::atomic<uint64_t> executed{0}, accepted{0};
+    const auto worker = [&executed](unsigned long long job) { check_job(executed, job); };
+    ThreadPool<unsigned long long, decltype(worker), queue_t> pool(CHECK_WORKERS, worker);
+
+    std::atomic<bool> running{true};
+    std::vector<std::vector<std::future<void>>> batches(CHECK_PRODUCERS);
+    std::vector<std::thread> producers;
+    for (unsigned int i = 0; i < CHECK_PRODUCERS; i++) {
+        producers.emplace_back([&, i]() { produce(pool, running, accepted, executed, batches[i]); });
+    }
+
+    bool ok = true;
+    for (unsigned int round = 0; round < CHECK_DRAINS && ok; round++) {
+        const uint64_t before = accepted.load();
+        finishes_in_time([&pool]() { pool.drain(); });
+        ok = pool.completed_jobs() >= before && executed.load() >= before;
+    }
+
+    running.store(false);
+    for (auto & producer : producers) producer.join();
+    pool.shutdown();
+    printf("%-14s drain under load        %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// Every call that returned normally before shutdown() must have its jobs run, every batch future must be ready
+template<template<typename> class queue_t>
+bool check_shutdown(const char * name) {
+    bool ok = true;
+    for (unsigned int round = 0; round < CHECK_SHUTDOWNS && ok; round++) {
+        std::atomic<uint64_t> executed{0}, accepted{0};
+        const auto worker = [&executed](unsigned long long job) { check_job(executed, job); };
+        std::atomic<bool> running{true};
+        std::vector<std::vector<std::future<void>>> batches(CHECK_PRODUCERS);
+        {
+            ThreadPool<unsigned long long, decltype(worker), queue_t> pool(CHECK_WORKERS, worker);
+            std::vector<std::thread> producers;
+            for (unsigned int i = 0; i < CHECK_PRODUCERS; i++) {
+                producers.emplace_back([&, i]() { produce(pool, running, accepted, executed, batches[i]); });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(round % 20 * 50));
+            finishes_in_time([&pool]() { pool.shutdown(); });
+            running.store(false);
+            for (auto & producer : producers) producer.join();
+        }
+        ok = executed.load() == accepted.load();
+        for (const auto & own : batches) {
+            for (const auto & batch : own) {
+                ok = ok && batch.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+        }
+    }
+    printf("%-14s shutdown under load     %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// The old calling sequence, process(0) for every worker and then join(), must finish all jobs and return
+template<template<typename> class queue_t>
+bool check_join(const char * name) {
+    std::atomic<uint64_t> executed{0};
+    const auto worker = [&executed](unsigned long long job) { check_job(executed, job); };
+    ThreadPool<unsigned long long, decltype(worker), queue_t> pool(CHECK_WORKERS, worker);
+    for (uint64_t i = 0; i < CHECK_BACKLOG; i++) pool.process(1);
+    for (unsigned int i = 0; i < CHECK_WORKERS; i++) pool.process(0);
+    finishes_in_time([&pool]() { pool.join(); });
+    const bool ok = executed.load() == CHECK_BACKLOG;
+    printf("%-14s join without shutdown   %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+bool run_checks() {
+    bool ok = true;
+    ok = check_drain<ListQueue>("list") && ok;
+    ok = check_drain<MPMCRingQueue>("mpmc-ring") && ok;
+    ok = check_drain<WorkStealingQueue>("work-stealing") && ok;
+    ok = check_shutdown<ListQueue>("list") && ok;
+    ok = check_shutdown<MPMCRingQueue>("mpmc-ring") && ok;
+    ok = check_shutdown<WorkStealingQueue>("work-stealing") && ok;
+    ok = check_join<ListQueue>("list") && ok;
+    ok = check_join<MPMCRingQueue>("mpmc-ring") && ok;
+    ok = check_join<WorkStealingQueue>("work-stealing") && ok;
+    return ok;
+}
+
+int main(int argc, char * argv[]) {
+
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        run_benchmarks();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "check") {
+        return run_checks() ? 0 : 1;
+    }
 
     /*
      * Tato funkce pocita ulohu zadanou konzumentovi.
@@ -51,7 +326,7 @@ int main() {
     };
 
     // Inicializace poolu vlaken, ktere zpracovavaji ulohy vytvarene producenty
-    ThreadPool<unsigned long long, decltype(worker)> pool(NWORKERS, worker);
+    ThreadPool<unsigned long long, decltype(worker)> pool(NWORKERS, MAX_WORKERS, worker);
 
     // Vytvareni vlaken producentu, produkujicich ulohy
     std::vector<std::thread> threads;
@@ -70,7 +345,8 @@ int main() {
                 if (VERBOSE) {
                     cout_mu.lock();
                     std::cout << "Thread " << this_id << " pushing to queue: " << data << ", sleeping for: "
-                              << sleepTime << std::endl;
+                              << sleepTime << ", workers: " << pool.size() << ", queue depth: "
+                              << pool.queue_depth() << std::endl;
                     cout_mu.unlock();
                 }
 
@@ -86,11 +362,8 @@ int main() {
     // Join pro producenty
     for(unsigned int i = 0 ; i < NPRODUCERS ; i++) threads[i].join();
 
-    // Ukoncovani cinnosti konzumentu
-    for(unsigned int i = 0 ; i < NWORKERS ; i++) pool.process(0);
-
-    // Join pro konzumenty
-    pool.join();
+    // Ukoncovani cinnosti konzumentu, dokonci ulohy ve fronte a pocka na ne
+    pool.shutdown();
 
     return 0;
 }
\ No newline at end of file
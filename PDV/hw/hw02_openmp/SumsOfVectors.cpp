@@ -9,7 +9,18 @@
 #include <iostream>
 #include <numeric>
 #include <algorithm>
+#include <omp.h>
 #include "SumsOfVectors.h"
+#include "_kernels/SumKernels.h"
+#include "_calibration/Calibration.h"
+#include "_partition/LptPartition.h"
+
+// Below this many bytes the flat variant does not open a parallel region at all
+const unsigned long FLAT_PARALLEL_THRESHOLD = 1UL << 16;
+// Hybrid variant: vectors longer than one chunk are summed chunk by chunk by all threads
+const unsigned long HYBRID_CHUNK_BYTES = 1UL << 20;
+// Small vectors are handed out in groups of this many to keep the dynamic schedule cheap
+const int HYBRID_SMALL_GROUP = 16;
 
 void
 sumsOfVectors_omp_per_vector(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long minVectorSize) {
@@ -102,3 +113,169 @@ void sumsOfVectors_omp_shuffle(const vector<vector<int8_t>> &data, vector<long>
 
     }
 }
+
+void sumsOfVectors_omp_flat(const FlatData &data, vector<long> &solution, unsigned long /*minVectorSize*/) {
+    // All vectors live in one buffer, so we split the bytes (not the vectors) evenly between
+    // threads. That balances any length distribution with static work assignment. A vector
+    // crossing a split point is summed by both threads and combined with an atomic add.
+
+    const unsigned long total = static_cast<unsigned long>(data.values.size());
+    const unsigned long count = data.size();
+
+#pragma omp parallel if(total > FLAT_PARALLEL_THRESHOLD)
+    {
+        // Vectors split between threads are accumulated, so they have to start at zero
+#pragma omp for schedule(static)
+        for (unsigned long i = 0; i < count; i++) solution[i] = 0;
+
+        const auto nthreads = static_cast<unsigned long>(omp_get_num_threads());
+        const auto tid = static_cast<unsigned long>(omp_get_thread_num());
+        const unsigned long begin = total * tid / nthreads;
+        const unsigned long end = total * (tid + 1) / nthreads;
+
+        if (begin < end) {
+            // Last vector starting at or before "begin"
+            unsigned long i = static_cast<unsigned long>(
+                    std::upper_bound(data.offsets.begin(), data.offsets.end(), begin) - data.offsets.begin()) - 1;
+
+            for (; i < count && data.offsets[i] < end; i++) {
+                const unsigned long lo = std::max(data.offsets[i], begin);
+                const unsigned long hi = std::min(data.offsets[i + 1], end);
+                if (lo >= hi) continue;
+
+                const long sum = sumInt8(data.values.data() + lo, hi - lo);
+                if (lo == data.offsets[i] && hi == data.offsets[i + 1]) {
+                    solution[i] = sum;
+                } else {
+#pragma omp atomic
+                    solution[i] += sum;
+                }
+            }
+        }
+    }
+}
+
+void sumsOfVectors_omp_lpt(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long /*minVectorSize*/) {
+    // Instead of shuffling and hoping, every thread gets a precomputed list of (parts of) vectors
+    // with about the same number of bytes. Giant vectors are cut into pieces whose partial sums
+    // are added up afterwards, so no atomics are needed.
+
+    vector<unsigned long> lengths(data.size());
+    for (unsigned long i = 0; i < data.size(); i++) lengths[i] = static_cast<unsigned long>(data[i].size());
+    const lptPartition_t partition = partitionLpt(lengths, static_cast<unsigned int>(omp_get_max_threads()));
+    vector<long> partials(partition.slots);
+
+#pragma omp parallel num_threads(static_cast<int>(partition.perThread.size()))
+    {
+        // The team may come up smaller (nesting, OMP_DYNAMIC, thread limit), then a thread takes several lists
+        const auto lists = static_cast<unsigned long>(partition.perThread.size());
+        for (auto t = static_cast<unsigned long>(omp_get_thread_num()); t < lists;
+             t += static_cast<unsigned long>(omp_get_num_threads())) {
+            for (const workUnit_t &unit : partition.perThread[t]) {
+                const long sum = sumInt8(data[unit.vector].data() + unit.begin, unit.end - unit.begin);
+                if (unit.slot == NO_SLOT) solution[unit.vector] = sum;
+                else partials[unit.slot] = sum;
+            }
+        }
+    }
+
+    for (const splitVector_t &split : partition.splits) {
+        long sum = 0;
+        for (unsigned long s = 0; s < split.slots; s++) sum += partials[split.firstSlot + s];
+        solution[split.vector] = sum;
+    }
+}
+
+void sumsOfVectors_omp_hybrid(const vector<vector<int8_t>> &data, vector<long> &solution,
+                              unsigned long /*minVectorSize*/) {
+    // Dynamic scheduling gives a huge vector to a single thread. Here huge vectors are cut into
+    // chunks and every thread takes chunks first, then falls through (nowait) to the small vectors,
+    // so a thread done with its chunks never waits for the others.
+
+    vector<workUnit_t> chunks;
+    vector<splitVector_t> huge;
+    vector<unsigned long> small;
+    for (unsigned long i = 0; i < data.size(); i++) {
+        const auto length = static_cast<unsigned long>(data[i].size());
+        if (length <= HYBRID_CHUNK_BYTES) {
+            small.push_back(i);
+            continue;
+        }
+        const unsigned long pieces = (length + HYBRID_CHUNK_BYTES - 1) / HYBRID_CHUNK_BYTES;
+        huge.push_back({i, chunks.size(), pieces});
+        for (unsigned long p = 0; p < pieces; p++) {
+            chunks.push_back({i, p * HYBRID_CHUNK_BYTES, std::min(length, (p + 1) * HYBRID_CHUNK_BYTES), chunks.size()});
+        }
+    }
+    vector<long> partials(chunks.size());
+
+#pragma omp parallel
+    {
+#pragma omp for schedule(dynamic) nowait
+        for (unsigned long c = 0; c < chunks.size(); c++) {
+            const workUnit_t &chunk = chunks[c];
+            partials[c] = sumInt8(data[chunk.vector].data() + chunk.begin, chunk.end - chunk.begin);
+        }
+
+#pragma omp for schedule(dynamic, HYBRID_SMALL_GROUP) nowait
+        for (unsigned long s = 0; s < small.size(); s++) {
+            const vector<int8_t> &v = data[small[s]];
+            solution[small[s]] = sumInt8(v.data(), v.size());
+        }
+    }
+
+    // Chunk sums are added in a fixed order, the result does not depend on the schedule
+    for (const splitVector_t &split : huge) {
+        long sum = 0;
+        for (unsigned long p = 0; p < split.slots; p++) sum += partials[split.firstSlot + p];
+        solution[split.vector] = sum;
+    }
+}
+
+SumsStrategy sumsOfVectors_choose(const vector<vector<int8_t>> &data, unsigned long /*minVectorSize*/) {
+    const strategyThresholds_t &thresholds = strategyThresholds();
+    const auto count = static_cast<unsigned long>(data.size());
+    const auto threads = static_cast<unsigned long>(omp_get_max_threads());
+    if (count == 0 || threads == 1) return SumsStrategy::SEQUENTIAL;
+
+    // All lengths are read, a sample would miss the few giant vectors that make the data skewed.
+    // It is one pass over the vector headers, cheap next to summing the bytes.
+    unsigned long totalBytes = 0, longest = 0;
+    for (unsigned long i = 0; i < count; i++) {
+        const auto length = static_cast<unsigned long>(data[i].size());
+        totalBytes += length;
+        longest = std::max(longest, length);
+    }
+    const double mean = static_cast<double>(totalBytes) / count;
+
+    // Not enough work to pay for a parallel region
+    if (totalBytes < thresholds.sequentialMaxBytes) return SumsStrategy::SEQUENTIAL;
+    // Fewer vectors than threads, each of them worth splitting
+    if (count < threads && longest >= thresholds.perVectorMinBytes) return SumsStrategy::PER_VECTOR;
+    // A few vectors dominate, equal chunks of indexes would not be equal work
+    if (longest > thresholds.skewMaxRatio * mean) return SumsStrategy::LPT;
+    return SumsStrategy::STATIC;
+}
+
+void sumsOfVectors_auto(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long minVectorSize) {
+    switch (sumsOfVectors_choose(data, minVectorSize)) {
+        case SumsStrategy::PER_VECTOR:
+            sumsOfVectors_omp_per_vector(data, solution, minVectorSize);
+            break;
+        case SumsStrategy::STATIC:
+            sumsOfVectors_omp_static(data, solution, minVectorSize);
+            break;
+        case SumsStrategy::LPT:
+            sumsOfVectors_omp_lpt(data, solution, minVectorSize);
+            break;
+        case SumsStrategy::SEQUENTIAL:
+            for (unsigned long i = 0; i < data.size(); i++) {
+                long sum = 0;
+                for (const int8_t &j : data[i]) {
+                    sum += j;
+                }
+                solution[i] = sum;
+            }
+            break;
+    }
+}
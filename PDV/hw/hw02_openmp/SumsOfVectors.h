@@ -2,6 +2,7 @@
 #define HW_VECTORFINDER_H
 
 #include <vector>
+#include "_dataGenerator/FlatData.h"
 
 using namespace std;
 
@@ -20,4 +21,28 @@ void
 sumsOfVectors_omp_dynamic(const vector<vector<int8_t>> &data, vector<long> &solution,
                           unsigned long minVectorSize);
 
+void
+sumsOfVectors_omp_flat(const FlatData &data, vector<long> &solution, unsigned long minVectorSize);
+
+// Deterministicka nahrada michani: vektory se rozdeli mezi vlakna metodou LPT (_partition/LptPartition.h)
+void
+sumsOfVectors_omp_lpt(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long minVectorSize);
+
+// Obri vektory se rozdeli na useky scitane vsemi vlakny, ostatni se zpracuji paralelne pres vektory,
+// obe faze bezi v jednom paralelnim regionu
+void
+sumsOfVectors_omp_hybrid(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long minVectorSize);
+
+// Strategie, mezi kterymi vybira sumsOfVectors_auto
+enum class SumsStrategy {
+    SEQUENTIAL, PER_VECTOR, STATIC, LPT
+};
+
+// Vybere strategii podle delek vektoru a prahu zmerenych pro tento stroj (_calibration/Calibration.h)
+SumsStrategy
+sumsOfVectors_choose(const vector<vector<int8_t>> &data, unsigned long minVectorSize);
+
+void
+sumsOfVectors_auto(const vector<vector<int8_t>> &data, vector<long> &solution, unsigned long minVectorSize);
+
 #endif //HW_VECTORFINDER_H
@@ -0,0 +1,102 @@
+#include "Calibration.h"
+#include <omp.h>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+// Pocet opakovani pri mereni rezie paralelniho regionu
+const int CALIBRATION_REGIONS = 200;
+// Velikost bufferu pro mereni rychlosti sekvencniho scitani
+const unsigned long CALIBRATION_BYTES = 1UL << 22;
+// Prahy nastavujeme s rezervou, aby sum v mereni neprepinal strategie tam a zpet
+const double SAFETY_FACTOR = 2.0;
+const double DEFAULT_SKEW_MAX_RATIO = 4.0;
+
+static string hostName() {
+#ifdef __unix__
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0 && name[0] != '\0') return string(name);
+#endif
+    return "default";
+}
+
+string calibrationFile() {
+    const char *path = getenv("SUMS_CALIBRATION_FILE");
+    if (path != nullptr) return string(path);
+    return "sumsOfVectors_" + hostName() + "_" + to_string(omp_get_max_threads()) + "t.calib";
+}
+
+strategyThresholds_t calibrateThresholds() {
+    // Rezie jednoho paralelniho regionu (fork + join)
+    volatile int sink = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < CALIBRATION_REGIONS; r++) {
+#pragma omp parallel
+        {
+            if (omp_get_thread_num() == 0) sink = sink + 1;
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    const double regionNs = static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - begin).count())
+                            / CALIBRATION_REGIONS;
+
+    // Rychlost sekvencniho souctu stejnou smyckou jako sumsOfVectors_sequential
+    vector<int8_t> buffer(CALIBRATION_BYTES);
+    for (unsigned long i = 0; i < buffer.size(); i++) buffer[i] = static_cast<int8_t>(i * 31);
+    begin = chrono::steady_clock::now();
+    long sum = 0;
+    for (const int8_t &j : buffer) sum += j;
+    end = chrono::steady_clock::now();
+    sink = sink + static_cast<int>(sum);
+    const double nsPerByte = max(1e-3, static_cast<double>(
+            chrono::duration_cast<chrono::nanoseconds>(end - begin).count()) / CALIBRATION_BYTES);
+
+    const double threads = max(2, omp_get_max_threads());
+    strategyThresholds_t thresholds;
+    // Paralelni vypocet musi usetrit vic, nez stoji otevreni regionu
+    thresholds.sequentialMaxBytes = static_cast<unsigned long>(SAFETY_FACTOR * regionNs / nsPerByte);
+    // Redukce uvnitr vektoru usetri (T - 1) / T jeho delky, ale plati region za kazdy vektor
+    thresholds.perVectorMinBytes = static_cast<unsigned long>(
+            SAFETY_FACTOR * regionNs * threads / ((threads - 1) * nsPerByte));
+    thresholds.skewMaxRatio = DEFAULT_SKEW_MAX_RATIO;
+    return thresholds;
+}
+
+static bool loadThresholds(const string &path, strategyThresholds_t &thresholds) {
+    ifstream in(path);
+    if (!in) return false;
+    string key;
+    int found = 0;
+    while (in >> key) {
+        if (key == "sequentialMaxBytes" && in >> thresholds.sequentialMaxBytes) found++;
+        else if (key == "perVectorMinBytes" && in >> thresholds.perVectorMinBytes) found++;
+        else if (key == "skewMaxRatio" && in >> thresholds.skewMaxRatio) found++;
+    }
+    return found == 3;
+}
+
+static void saveThresholds(const string &path, const strategyThresholds_t &thresholds) {
+    ofstream out(path);
+    out << "sequentialMaxBytes " << thresholds.sequentialMaxBytes << "\n";
+    out << "perVectorMinBytes " << thresholds.perVectorMinBytes << "\n";
+    out << "skewMaxRatio " << thresholds.skewMaxRatio << "\n";
+}
+
+const strategyThresholds_t &strategyThresholds() {
+    static const strategyThresholds_t thresholds = []() {
+        const string path = calibrationFile();
+        strategyThresholds_t loaded;
+        if (loadThresholds(path, loaded)) return loaded;
+        const strategyThresholds_t measured = calibrateThresholds();
+        saveThresholds(path, measured);
+        return measured;
+    }();
+    return thresholds;
+}
@@ -0,0 +1,28 @@
+#ifndef HW_CALIBRATION_H
+#define HW_CALIBRATION_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ *  Prahy, podle kterych sumsOfVectors_auto vybira strategii. Zavisi na stroji (rezie otevreni
+ *  paralelniho regionu, rychlost scitani), proto se zmeri jednou a ulozi do souboru.
+ */
+typedef struct strategyThresholds {
+    unsigned long sequentialMaxBytes;   // mene dat nez tolik bajtu se vyplati pocitat sekvencne
+    unsigned long perVectorMinBytes;    // od teto delky se vyplati paralelni redukce uvnitr vektoru
+    double skewMaxRatio;                // pomer nejdelsiho a prumerneho vektoru, od ktereho je staticke
+                                        // rozvrhovani vnejsi smycky nevyvazene
+} strategyThresholds_t;
+
+// Zmeri prahy na aktualnim stroji (trva radove desitky milisekund)
+strategyThresholds_t calibrateThresholds();
+
+// Soubor s prahy pro tento stroj a pocet vlaken, lze zmenit promennou prostredi SUMS_CALIBRATION_FILE
+string calibrationFile();
+
+// Prahy nactene ze souboru, pripadne nove zmerene a ulozene. Vysledek se pamatuje do konce behu.
+const strategyThresholds_t &strategyThresholds();
+
+#endif //HW_CALIBRATION_H
@@ -1,38 +1,262 @@
-
 #include "DataGenerator.h"
 
+#include <omp.h>
+#include <cstring>
+#include <cstdio>
 
-void DataGenerator::generateData(vector<long> &solution, vector<vector<int8_t>> &data) const {
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HW_DATA_CACHE_MMAP 1
+#endif
+
+// Data se generuji po blocich teto velikosti (v bajtech pres vsechny vektory)
+const unsigned long GENERATE_BLOCK_BYTES = 1UL << 20;
+
+const uint64_t DEFAULT_SEED = 0x5eed2023UL;
+
+// Hlavicka souboru s ulozenou datovou sadou, za ni nasleduji delky vektoru (count x uint64),
+// reseni (count x int64) a nakonec vsechny vektory za sebou (totalBytes x int8)
+struct cacheHeader {
+    char magic[8];
+    uint64_t seed;
+    uint64_t count;
+    uint64_t totalBytes;
+};
+
+const char CACHE_MAGIC[8] = {'H', 'W', '0', '2', 'D', 'A', 'T', '1'};
+
+// SplitMix64 jako funkce citace: k-te 64bitove slovo nahodnych bitu pro dane seme
+static inline uint64_t randomWord(uint64_t seed, uint64_t k) {
+    uint64_t z = seed + (k + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Vyplni "count" bajtu od globalni pozice "position" a vrati jejich soucet
+static long fillRandom(int8_t *out, uint64_t seed, unsigned long position, unsigned long count) {
+    long sum = 0;
+    unsigned long k = 0;
+    while (k < count) {
+        const uint64_t word = randomWord(seed, (position + k) / 8);
+        for (unsigned long byte = (position + k) % 8; byte < 8 && k < count; byte++, k++) {
+            const auto value = static_cast<int8_t>((word >> (8 * byte)) & 0x7F);
+            out[k] = value;
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+static uint64_t seedFromEnvironment() {
+    const char *value = getenv("HW02_SEED");
+    return value != nullptr ? strtoull(value, nullptr, 0) : DEFAULT_SEED;
+}
+
+DataGenerator::DataGenerator() : DataGenerator(seedFromEnvironment()) {}
+
+DataGenerator::DataGenerator(uint64_t seed) : seed(seed) {}
+
+// Vygeneruje data vektoru s danymi pozicemi zacatku (offsets) a spocita jejich soucty. vectorData(i) vraci
+// pamet i-teho vektoru, takze stejny kod plni souvisle pole i samostatne vektory.
+template<typename vectorData_t>
+static void fillData(uint64_t seed, const vector<unsigned long> &offsets, vector<long> &solution,
+                     vectorData_t vectorData) {
+    const auto countOfVectors = static_cast<unsigned long>(offsets.size() - 1);
+    const unsigned long total = offsets.back();
+    const unsigned long blocks = (total + GENERATE_BLOCK_BYTES - 1) / GENERATE_BLOCK_BYTES;
+
+    // Vygenerujeme data. Vektory pres hranici bloku scita vice vlaken, proto se soucty nuluji
+    // a jejich casti se pricitaji atomicky.
+#pragma omp parallel
+    {
+#pragma omp for schedule(static)
+        for (unsigned long i = 0; i < countOfVectors; i++) solution[i] = 0;
+
+#pragma omp for schedule(dynamic)
+        for (unsigned long b = 0; b < blocks; b++) {
+            const unsigned long begin = b * GENERATE_BLOCK_BYTES;
+            const unsigned long end = std::min(total, begin + GENERATE_BLOCK_BYTES);
+
+            auto i = static_cast<unsigned long>(upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()) - 1;
+            for (; i < countOfVectors && offsets[i] < end; i++) {
+                const unsigned long lo = std::max(offsets[i], begin);
+                const unsigned long hi = std::min(offsets[i + 1], end);
+                if (lo >= hi) continue;
+
+                const long sum = fillRandom(vectorData(i) + (lo - offsets[i]), seed, lo, hi - lo);
+                if (lo == offsets[i] && hi == offsets[i + 1]) {
+                    solution[i] = sum;
+                } else {
+#pragma omp atomic
+                    solution[i] += sum;
+                }
+            }
+        }
+    }
+}
+
+// Pozice zacatku vektoru, jako kdyby byly vsechny za sebou
+static vector<unsigned long> offsetsOf(const vector<vector<int8_t>> &data) {
+    vector<unsigned long> offsets(data.size() + 1, 0);
+    for (unsigned long i = 0; i < data.size(); i++) {
+        offsets[i + 1] = offsets[i] + static_cast<unsigned long>(data[i].size());
+    }
+    return offsets;
+}
+
+void DataGenerator::generateData(vector<long> &solution, FlatData &data) const {
+
+    if (data.size() != solution.size()) {
+        throw invalid_argument("Solution vector and count of vectors in data lengths differ.");
+    }
 
-    // Nahodny generator je inicializovan pomoci aktualniho casu
-    srand(static_cast<unsigned>(time(nullptr)));
+    int8_t *values = data.values.data();
+    fillData(seed, data.offsets, solution, [values, &data](unsigned long i) { return values + data.offsets[i]; });
+}
+
+void DataGenerator::generateData(vector<long> &solution, vector<vector<int8_t>> &data) const {
 
     if (data.size() != solution.size()) {
         throw invalid_argument("Solution vector and count of vectors in data lengths differ.");
     }
 
-    const auto countOfVectors = static_cast<unsigned long>(data.size());
+    fillData(seed, offsetsOf(data), solution, [&data](unsigned long i) { return data[i].data(); });
+}
+
+// Nacte datovou sadu ze souboru, pokud odpovida semenem i delkami vektoru (dany pozicemi zacatku)
+template<typename vectorData_t>
+static bool loadCached(const string &path, uint64_t seed, const vector<unsigned long> &offsets,
+                       vector<long> &solution, vectorData_t vectorData) {
+#ifdef HW_DATA_CACHE_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(cacheHeader)) {
+        close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    const auto *bytes = static_cast<const char *>(mapped);
+    cacheHeader header{};
+    memcpy(&header, bytes, sizeof(header));
+    const uint64_t count = offsets.size() - 1;
+    bool matches = memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 && header.seed == seed &&
+                   header.count == count && header.totalBytes == offsets.back() &&
+                   size == sizeof(cacheHeader) + count * (sizeof(uint64_t) + sizeof(int64_t)) + header.totalBytes;
+
+    const char *lengths = bytes + sizeof(cacheHeader);
+    const char *sums = lengths + count * sizeof(uint64_t);
+    const char *values = sums + count * sizeof(int64_t);
+    for (uint64_t i = 0; matches && i < count; i++) {
+        uint64_t length;
+        memcpy(&length, lengths + i * sizeof(uint64_t), sizeof(length));
+        matches = length == offsets[i + 1] - offsets[i];
+    }
+
+    if (matches) {
+        memcpy(solution.data(), sums, count * sizeof(int64_t));
+#pragma omp parallel for schedule(dynamic, 64)
+        for (uint64_t i = 0; i < count; i++) {
+            memcpy(vectorData(i), values + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+    }
+    munmap(mapped, size);
+    return matches;
+#else
+    (void) path;
+    (void) seed;
+    (void) offsets;
+    (void) solution;
+    (void) vectorData;
+    return false;
+#endif
+}
+
+// Soubor je souvisle pole, takze se zapisuje rovnou z FlatData
+static void saveCached(const string &path, uint64_t seed, const vector<long> &solution, const FlatData &data) {
+    cacheHeader header{};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.seed = seed;
+    header.count = data.size();
+    header.totalBytes = data.values.size();
 
-    // Vygenerujeme data
-    for (unsigned long i = 0; i < countOfVectors; i++) {
-        unsigned long sum = 0, number;
-        for (int8_t &j : data[i]) {
-            number = rand() % 128;
-            j = static_cast<int8_t>(number);
-            sum += number;
+    // Zapisujeme do docasneho souboru, aby prerusene ulozeni nezanechalo poskozena data
+    const string temporary = path + ".tmp";
+    {
+        ofstream out(temporary, ios::binary | ios::trunc);
+        if (!out) return;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (unsigned long i = 0; i < data.size(); i++) {
+            const uint64_t length = data.length(i);
+            out.write(reinterpret_cast<const char *>(&length), sizeof(length));
         }
-        solution[i] = static_cast<long>(sum);
+        for (const long sum : solution) {
+            const int64_t value = sum;
+            out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+        out.write(reinterpret_cast<const char *>(data.values.data()), static_cast<streamsize>(data.values.size()));
+        if (!out) return;
+    }
+    rename(temporary.c_str(), path.c_str());
+}
+
+// Cesta k souboru datove sady, prazdna pokud HW02_DATA_CACHE neni nastavena
+static string cachePath(const string &name) {
+    const char *directory = getenv("HW02_DATA_CACHE");
+    if (directory == nullptr || *directory == '\0') return string();
+    return string(directory) + "/" + name + ".bin";
+}
+
+void DataGenerator::generateDataCached(const string &name, vector<long> &solution, FlatData &data) const {
+    const string path = cachePath(name);
+    if (path.empty()) {
+        generateData(solution, data);
+        return;
+    }
+
+    if (data.size() != solution.size()) {
+        throw invalid_argument("Solution vector and count of vectors in data lengths differ.");
     }
+
+    int8_t *values = data.values.data();
+    if (loadCached(path, seed, data.offsets, solution,
+                   [values, &data](unsigned long i) { return values + data.offsets[i]; })) return;
+
+    generateData(solution, data);
+    saveCached(path, seed, solution, data);
+}
+
+vector<vector<int8_t>> DataGenerator::nestedDataCached(const string &name, FlatData &&data) const {
+    // Z plocheho pole zustanou jen delky, hodnoty se uvolni drive, nez vzniknou samostatne vektory
+    const vector<unsigned long> offsets = std::move(data.offsets);
+    data = FlatData();
+
+    vector<vector<int8_t>> nested;
+    nested.reserve(offsets.size() - 1);
+    for (unsigned long i = 0; i + 1 < offsets.size(); i++) nested.emplace_back(offsets[i + 1] - offsets[i]);
+
+    vector<long> solution(nested.size());
+    const string path = cachePath(name);
+    if (path.empty() ||
+        !loadCached(path, seed, offsets, solution, [&nested](unsigned long i) { return nested[i].data(); })) {
+        generateData(solution, nested);
+    }
+    return nested;
 }
 
 // Prevzato z https://stackoverflow.com/questions/38244877/how-to-use-stdnormal-distribution
 void DataGenerator::generateDistribution(vector<int> &vector, const int mean, const int sigma, const int beginIndex) const {
 
-    // random device class instance, source of 'true' randomness for initializing random seed
-    std::random_device rd;
-
-    // Mersenne twister PRNG, initialized with seed from previous random device instance
-    std::mt19937 gen(rd());
+    // Mersenne twister PRNG, initialized from the generator seed, so that lengths are reproducible too
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(seed + static_cast<uint64_t>(beginIndex)));
 
     for (unsigned long i = beginIndex; i < vector.size(); ++i) {
 
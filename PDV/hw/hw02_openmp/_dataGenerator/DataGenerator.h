@@ -6,6 +6,9 @@
 #include <ctime>
 #include <algorithm>
 #include <iostream>
+#include <string>
+#include <cstdint>
+#include "FlatData.h"
 
 using namespace std;
 
@@ -14,14 +17,43 @@ using namespace std;
 
 class DataGenerator {
 
+    // Vsechna data jsou funkci semene a pozice, nezalezi tedy na poctu vlaken
+    uint64_t seed;
+
 public:
 
-    // Uniformni generator cisel
+    // Seme lze zmenit promennou prostredi HW02_SEED, jinak se pouzije pevna hodnota
+    DataGenerator();
+
+    explicit DataGenerator(uint64_t seed);
+
+    // Uniformni generator cisel (0 az 127). Bajt na pozici p (pocitano pres vsechny vektory za sebou)
+    // je urcen jen semenem a p, takze se data generuji paralelne a pri tom se rovnou scitaji.
     // Parametry:
-    //      data - datova sada
+    //      data - datova sada (delky vektoru musi byt nastavene)
     //      solution - suma kazdeho vektoru cisel v datove sade
+    void generateData(vector<long> &solution, FlatData &data) const;
+
+    // Stejna data zapsana do samostatnych vektoru
     void generateData(vector<long> &solution, vector<vector<int8_t>> &data) const;
 
+    // Stejne jako generateData, ale je-li nastavena promenna prostredi HW02_DATA_CACHE (adresar),
+    // nacte datovou sadu ze souboru "<adresar>/<name>.bin" (pres mmap), pokud odpovida semenem
+    // i delkami vektoru. Jinak data vygeneruje a soubor prepise.
+    // Parametry:
+    //      name - jmeno datove sady
+    //      data - datova sada (delky vektoru musi byt nastavene)
+    //      solution - suma kazdeho vektoru cisel v datove sade
+    void generateDataCached(const string &name, vector<long> &solution, FlatData &data) const;
+
+    // Tataz datova sada jako samostatne vektory (pro implementace nad vector<vector<int8_t>>). Hodnoty
+    // plocheho pole se nejdriv uvolni a vektory se pak znovu vygeneruji (nebo nactou ze souboru) - data
+    // jsou funkci semene a pozice, takze jsou stejna, a v pameti nikdy nejsou obe podoby najednou.
+    // Parametry:
+    //      name - jmeno datove sady (jako u generateDataCached)
+    //      data - datova sada, po volani je prazdna
+    vector<vector<int8_t>> nestedDataCached(const string &name, FlatData &&data) const;
+
 
     // Gaussovsky generator cisel
     // Parametry:
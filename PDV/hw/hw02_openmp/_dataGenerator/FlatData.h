@@ -0,0 +1,39 @@
+#ifndef HW_FLATDATA_H
+#define HW_FLATDATA_H
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ *  Datova sada ulozena v jednom souvislem poli (obdoba CSR formatu). Vektor i zabira
+ *  prvky values[offsets[i]] az values[offsets[i + 1] - 1], offsets ma tedy o jeden prvek vice
+ *  nez je vektoru. Na rozdil od vector<vector<int8_t>> neni kazdy vektor samostatnou alokaci.
+ */
+struct FlatData {
+    vector<int8_t> values;
+    vector<unsigned long> offsets{0};
+
+    FlatData() = default;
+
+    // Datova sada s danymi delkami vektoru, hodnoty jsou nulove
+    template<typename length_t>
+    explicit FlatData(const vector<length_t> &lengths) : offsets(lengths.size() + 1, 0) {
+        for (unsigned long i = 0; i < lengths.size(); i++) {
+            offsets[i + 1] = offsets[i] + static_cast<unsigned long>(lengths[i]);
+        }
+        values.resize(offsets.back());
+    }
+
+    // "count" vektoru delky "length"
+    FlatData(unsigned long count, unsigned long length) : FlatData(vector<unsigned long>(count, length)) {}
+
+    unsigned long size() const { return static_cast<unsigned long>(offsets.size() - 1); }
+
+    unsigned long length(unsigned long i) const { return offsets[i + 1] - offsets[i]; }
+
+    const int8_t *vectorData(unsigned long i) const { return values.data() + offsets[i]; }
+};
+
+#endif //HW_FLATDATA_H
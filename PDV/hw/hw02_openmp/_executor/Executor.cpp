@@ -45,15 +45,42 @@ long Executor::executeMethod(
     return -1L;
 }
 
-results_t Executor::executeMethods(const vector<long> &solution, const vector<vector<int8_t>> &data) const {
+long Executor::executeMethod(
+        void (*functionPtr)(const FlatData &, vector<long> &, const unsigned long minVectorSize),
+        const vector<long> &solution, const FlatData &data, unsigned long minVectorSize) const {
+    try {
+        vector<long> result(data.size());
+
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        (*functionPtr)(data, result, minVectorSize);
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+        if (result == solution) {
+            return static_cast<long>(chrono::duration_cast<chrono::nanoseconds>(end - begin).count());
+        }
+    } catch (...) {
+        //ignored
+    }
+
+    return -1L;
+}
+
+void Executor::executeFlatMethods(const vector<long> &solution, const FlatData &data, results_t &results) const {
+    unsigned long shortestVectorLength = findLengthOfShortestVector(data);
+    results.flatSimdTime = executeMethod(&sumsOfVectors_omp_flat, solution, data, shortestVectorLength);
+}
+
+void Executor::executeMethods(const vector<long> &solution, const vector<vector<int8_t>> &data,
+                              results_t &results) const {
     unsigned long shortestVectorLength = findLengthOfShortestVector(data);
-    long referenceTime = executeMethod(&sumsOfVectors_sequential, solution, data, shortestVectorLength);
-    long perVectorTime = executeMethod(&sumsOfVectors_omp_per_vector, solution, data, shortestVectorLength);
-    long withShuffleTime = executeMethod(&sumsOfVectors_omp_shuffle, solution, data, shortestVectorLength);
-    long dynamicSchedTime = executeMethod(&sumsOfVectors_omp_dynamic, solution, data, shortestVectorLength);
-    long staticSchedulingTime = executeMethod(&sumsOfVectors_omp_static, solution, data,
-                                              shortestVectorLength);
-    return {referenceTime, perVectorTime, withShuffleTime, dynamicSchedTime, staticSchedulingTime};
+    results.referenceTime = executeMethod(&sumsOfVectors_sequential, solution, data, shortestVectorLength);
+    results.perVectorTime = executeMethod(&sumsOfVectors_omp_per_vector, solution, data, shortestVectorLength);
+    results.withShuffleTime = executeMethod(&sumsOfVectors_omp_shuffle, solution, data, shortestVectorLength);
+    results.dynamicSchedulingTime = executeMethod(&sumsOfVectors_omp_dynamic, solution, data, shortestVectorLength);
+    results.staticSchedulingTime = executeMethod(&sumsOfVectors_omp_static, solution, data, shortestVectorLength);
+    results.autoTime = executeMethod(&sumsOfVectors_auto, solution, data, shortestVectorLength);
+    results.lptTime = executeMethod(&sumsOfVectors_omp_lpt, solution, data, shortestVectorLength);
+    results.hybridTime = executeMethod(&sumsOfVectors_omp_hybrid, solution, data, shortestVectorLength);
 }
 
 unsigned long Executor::findLengthOfShortestVector(const vector<vector<int8_t>> &data) const {
@@ -75,4 +102,10 @@ unsigned long Executor::findLengthOfShortestVector(const vector<vector<int8_t>>
             
     }
     return minNumber;
+}
+
+unsigned long Executor::findLengthOfShortestVector(const FlatData &data) const {
+    unsigned long minNumber = ULONG_MAX;
+    for (unsigned long i = 0; i < data.size(); i++) minNumber = std::min(minNumber, data.length(i));
+    return minNumber;
 }
\ No newline at end of file
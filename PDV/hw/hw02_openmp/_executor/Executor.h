@@ -17,13 +17,18 @@ typedef struct results {
     long withShuffleTime;           // rychlost implementace s "michanim" a statickym rozvrhovanim
     long dynamicSchedulingTime;     // rychlost implementace s dynamickym rozvrhovanim
     long staticSchedulingTime;      // rychlost implementace s statickym rozvrhovanim
+    long flatSimdTime;              // rychlost implementace nad souvislym polem se SIMD souctem
+    long autoTime;                  // rychlost implementace s automatickou volbou strategie
+    long lptTime;                   // rychlost implementace s rozdelenim prace metodou LPT
+    long hybridTime;                // rychlost hybridni implementace (obri vektory po usecich, ostatni pres vektory)
 
     results(long referenceTime, long perVectorTime, long withShuffleTime, long dynamicSchedulingTime,
-            long staticSchedulingTime)
+            long staticSchedulingTime, long flatSimdTime, long autoTime, long lptTime, long hybridTime)
             : referenceTime(referenceTime), perVectorTime(perVectorTime), withShuffleTime(withShuffleTime),
-              dynamicSchedulingTime(dynamicSchedulingTime), staticSchedulingTime(staticSchedulingTime) {};
+              dynamicSchedulingTime(dynamicSchedulingTime), staticSchedulingTime(staticSchedulingTime),
+              flatSimdTime(flatSimdTime), autoTime(autoTime), lptTime(lptTime), hybridTime(hybridTime) {};
 
-    results() : results(-1L, -1L, -1L, -1L, -1L) {}
+    results() : results(-1L, -1L, -1L, -1L, -1L, -1L, -1L, -1L, -1L) {}
 
 } results_t;
 
@@ -38,9 +43,20 @@ public:
                        const vector<long> &solution,
                        const vector<vector<int8_t>> &data, unsigned long minVectorSize) const;
 
-    results_t executeMethods(const vector<long> &solution, const vector<vector<int8_t>> &data) const;
+    // Varianta pro implementace pracujici nad FlatData
+    long executeMethod(void (*functionPtr)(const FlatData &, vector<long> &, unsigned long minVectorSize),
+                       const vector<long> &solution,
+                       const FlatData &data, unsigned long minVectorSize) const;
+
+    // Spusti implementace nad FlatData a doplni jejich casy do "results"
+    void executeFlatMethods(const vector<long> &solution, const FlatData &data, results_t &results) const;
+
+    // Spusti implementace nad vector<vector<int8_t>> a doplni jejich casy do "results"
+    void executeMethods(const vector<long> &solution, const vector<vector<int8_t>> &data, results_t &results) const;
 
     unsigned long findLengthOfShortestVector(const vector<vector<int8_t>> &data) const;
+
+    unsigned long findLengthOfShortestVector(const FlatData &data) const;
 };
 
 
@@ -0,0 +1,79 @@
+#include "SumKernels.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define HW_SIMD_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// Prevod int8 -> long brani prekladaci ve vektorizaci, proto si soucet napiseme sami:
+//   - bajt x se znamenkem prevedeme na x + 128 bez znamenka (xor s 0x80),
+//   - _mm_sad_epu8 proti nulovemu registru secte vzdy 8 bajtu do jednoho 64bitoveho cisla,
+//   - na konci odecteme 128 za kazdy zpracovany bajt.
+// 64bitove mezisoucty nemohou pretect ani pro nejdelsi vektory.
+
+long sumInt8_scalar(const int8_t *values, size_t count) {
+    long sum = 0;
+    for (size_t i = 0; i < count; i++) sum += values[i];
+    return sum;
+}
+
+#ifdef HW_SIMD_DISPATCH
+
+__attribute__((target("sse2")))
+static long sumInt8_sse2(const int8_t *values, size_t count) {
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+
+    const size_t blocks = count / 16;
+    for (size_t b = 0; b < blocks; b++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + b * 16));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(v, bias), zero));
+    }
+
+    const long biased = static_cast<long>(_mm_cvtsi128_si64(acc)) +
+                        static_cast<long>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+    return biased - 128L * static_cast<long>(blocks * 16) + sumInt8_scalar(values + blocks * 16, count % 16);
+}
+
+__attribute__((target("avx2")))
+static long sumInt8_avx2(const int8_t *values, size_t count) {
+    const __m256i bias = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i zero = _mm256_setzero_si256();
+    // Dva nezavisle akumulatory, aby na sebe scitani necekala
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+
+    const size_t blocks = count / 64;
+    for (size_t b = 0; b < blocks; b++) {
+        const int8_t *p = values + b * 64;
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+        acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_xor_si256(v0, bias), zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_xor_si256(v1, bias), zero));
+    }
+
+    const __m256i acc = _mm256_add_epi64(acc0, acc1);
+    const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    const long biased = static_cast<long>(_mm_cvtsi128_si64(half)) +
+                        static_cast<long>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half)));
+    return biased - 128L * static_cast<long>(blocks * 64) + sumInt8_sse2(values + blocks * 64, count % 64);
+}
+
+#endif
+
+typedef long (*sumKernel_t)(const int8_t *, size_t);
+
+static sumKernel_t selectKernel() {
+#ifdef HW_SIMD_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return &sumInt8_avx2;
+    if (__builtin_cpu_supports("sse2")) return &sumInt8_sse2;
+#endif
+    return &sumInt8_scalar;
+}
+
+long sumInt8(const int8_t *values, size_t count) {
+    static const sumKernel_t kernel = selectKernel();
+    return kernel(values, count);
+}
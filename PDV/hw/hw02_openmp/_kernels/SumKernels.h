@@ -0,0 +1,14 @@
+#ifndef HW_SUMKERNELS_H
+#define HW_SUMKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Soucet "count" bajtu se znamenkem. Pri prvnim volani se vybere nejrychlejsi implementace,
+// kterou procesor podporuje (AVX2, SSE2, jinak skalarni smycka).
+long sumInt8(const int8_t *values, size_t count);
+
+// Skalarni implementace, slouzi i pro dopocitani zbytku za SIMD bloky
+long sumInt8_scalar(const int8_t *values, size_t count);
+
+#endif //HW_SUMKERNELS_H
@@ -0,0 +1,65 @@
+#include "LptPartition.h"
+
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+// I prazdny vektor neco stoji (hlavicka vektoru, zapis vysledku), aby se vlaknu nepriradily
+// tisice kratkych vektoru "zadarmo"
+const unsigned long PER_VECTOR_COST = 64;
+
+lptPartition_t partitionLpt(const vector<unsigned long> &lengths, unsigned int threads) {
+    lptPartition_t partition;
+    threads = std::max(threads, 1U);
+    partition.perThread.resize(threads);
+
+    unsigned long total = 0;
+    for (const unsigned long length : lengths) total += length + PER_VECTOR_COST;
+    const unsigned long share = std::max(total / threads, PER_VECTOR_COST);
+
+    // Useky k rozdeleni, obri vektory jsou rozsekane na kusy o velikosti nejvyse "share"
+    vector<workUnit_t> units;
+    units.reserve(lengths.size());
+    for (unsigned long i = 0; i < lengths.size(); i++) {
+        const unsigned long length = lengths[i];
+        if (length <= share || threads == 1) {
+            units.push_back({i, 0, length, NO_SLOT});
+            continue;
+        }
+        const unsigned long pieces = std::min<unsigned long>((length + share - 1) / share, threads);
+        partition.splits.push_back({i, partition.slots, pieces});
+        for (unsigned long p = 0; p < pieces; p++) {
+            units.push_back({i, length * p / pieces, length * (p + 1) / pieces, partition.slots++});
+        }
+    }
+
+    // Sestupne podle delky, pri shode podle poradi, aby bylo rozdeleni deterministicke
+    std::sort(units.begin(), units.end(), [](const workUnit_t &a, const workUnit_t &b) {
+        const unsigned long la = a.end - a.begin, lb = b.end - b.begin;
+        if (la != lb) return la > lb;
+        if (a.vector != b.vector) return a.vector < b.vector;
+        return a.begin < b.begin;
+    });
+
+    // Halda (prace, vlakno), na vrcholu je nejmene vytizene vlakno s nejnizsim cislem
+    typedef pair<unsigned long, unsigned int> load_t;
+    priority_queue<load_t, vector<load_t>, greater<load_t>> loads;
+    for (unsigned int t = 0; t < threads; t++) loads.push({0, t});
+
+    for (const workUnit_t &unit : units) {
+        load_t least = loads.top();
+        loads.pop();
+        partition.perThread[least.second].push_back(unit);
+        least.first += unit.end - unit.begin + PER_VECTOR_COST;
+        loads.push(least);
+    }
+
+    // Vlakno pak prochazi sve useky v poradi pameti
+    for (auto &own : partition.perThread) {
+        std::sort(own.begin(), own.end(), [](const workUnit_t &a, const workUnit_t &b) {
+            return a.vector != b.vector ? a.vector < b.vector : a.begin < b.begin;
+        });
+    }
+    return partition;
+}
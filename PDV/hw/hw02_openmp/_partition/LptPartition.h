@@ -0,0 +1,46 @@
+#ifndef HW_LPTPARTITION_H
+#define HW_LPTPARTITION_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ *  Souvisly usek [begin, end) vektoru "vector". Pokud je vektor rozdeleny mezi vice vlaken,
+ *  ma usek vlastni "slot" pro mezisoucet, jinak je slot roven NO_SLOT a vysledek se zapise primo.
+ */
+typedef struct workUnit {
+    unsigned long vector;
+    unsigned long begin;
+    unsigned long end;
+    unsigned long slot;
+} workUnit_t;
+
+const unsigned long NO_SLOT = static_cast<unsigned long>(-1);
+
+/**
+ *  Vektor rozdeleny na vice useku, jeho soucet je soucet slotu [firstSlot, firstSlot + slots).
+ */
+typedef struct splitVector {
+    unsigned long vector;
+    unsigned long firstSlot;
+    unsigned long slots;
+} splitVector_t;
+
+/**
+ *  Staticke rozdeleni prace mezi vlakna. Vlakno t zpracuje useky perThread[t], nakonec se
+ *  sectou mezisoucty rozdelenych vektoru (splits). Pro stejne delky a pocet vlaken je rozdeleni
+ *  vzdy stejne.
+ */
+typedef struct lptPartition {
+    vector<vector<workUnit_t>> perThread;
+    vector<splitVector_t> splits;
+    unsigned long slots = 0;
+} lptPartition_t;
+
+// Rozdeli vektory s danymi delkami mezi "threads" vlaken metodou LPT (longest processing time first):
+// useky se seradi sestupne podle delky a kazdy dostane vlakno s nejmensi dosavadni praci. Vektory delsi
+// nez idealni podil jednoho vlakna se nejprve rozdeli na stejne dlouhe useky.
+lptPartition_t partitionLpt(const vector<unsigned long> &lengths, unsigned int threads);
+
+#endif //HW_LPTPARTITION_H
@@ -7,6 +7,7 @@
 #include "_dataGenerator/DataGenerator.h"
 #include "_executor/Executor.h"
 #include "_outputGenerator/TextTable.h"
+#include "_calibration/Calibration.h"
 
 using namespace std;
 
@@ -30,6 +31,12 @@ string convertTimeToString(long nanos) {
     else return to_string(nanos) + "ns";
 }
 
+// Cas metody spolu se zrychlenim oproti sekvencnimu reseni
+string convertTimeWithSpeedupToString(long nanos, long referenceNanos) {
+    if (nanos <= 0 || referenceNanos <= 0) return convertTimeToString(nanos);
+    return convertTimeToString(nanos) + " (" + as_string(static_cast<double>(referenceNanos) / nanos, 2) + "x)";
+}
+
 // Naplneni radku tabulky vysledku
 void addRowWithResultsToTable(const string &typeOfData, const results_t &results, TextTable &table) {
     table.add(typeOfData);
@@ -38,22 +45,36 @@ void addRowWithResultsToTable(const string &typeOfData, const results_t &results
     table.add(convertTimeToString(results.withShuffleTime));
     table.add(convertTimeToString(results.dynamicSchedulingTime));
     table.add(convertTimeToString(results.staticSchedulingTime));
+    table.add(convertTimeToString(results.flatSimdTime));
+    table.add(convertTimeToString(results.autoTime));
+    table.add(convertTimeToString(results.lptTime));
+    table.add(convertTimeWithSpeedupToString(results.hybridTime, results.referenceTime));
     table.endOfRow();
 }
 
+// Spusti implementace nad datovou sadou a prida radek do tabulky. Nejdriv se spusti implementace nad souvislym
+// polem, pak se z nej udelaji samostatne vektory pro ostatni implementace (ploche pole se pri tom uvolni).
+void solveDataSet(const string &name, const string &typeOfData, const vector<long> &solution, FlatData &&data,
+                  TextTable &table) {
+    results_t results;
+    executor.executeFlatMethods(solution, data, results);
+    const vector<vector<int8_t>> nested = generator.nestedDataCached(name, std::move(data));
+    executor.executeMethods(solution, nested, results);
+    addRowWithResultsToTable(typeOfData, results, table);
+}
+
 // Prvni sada dat, ktera obsahuje velice malo hodne dlouhych vektoru
 // Tato sada je vhodna pro paralelizaci na urovni vektoru. Tento zpusob paralelizace by mel byt v tomto pripade nejrychlejsi
 void generateAndSolveFirstDataSet(TextTable &table) {
     //vytvarime 2 vektory, ktere maji kazdy 500'000'000 pseudonahodne generovanych cisel
-    vector<vector<int8_t>> data(2, vector<int8_t>(500'000'000));
+    FlatData data(2, 500'000'000);
     //spravne reseni
     vector<long> solution(2);
-    //nagenerujeme data a ulozime si spravne reseni
-    generator.generateData(solution, data);
+    //nagenerujeme data (nebo je nacteme z HW02_DATA_CACHE) a ulozime si spravne reseni
+    generator.generateDataCached("firstDataSet", solution, data);
 
     // Zavolame metody, ktere jste naimplementovali a pridame radek do tabulky
-    auto results = executor.executeMethods(solution, data);
-    addRowWithResultsToTable("Malo hodne dlouhych vektoru", results, table);
+    solveDataSet("firstDataSet", "Malo hodne dlouhych vektoru", solution, std::move(data), table);
 }
 
 // Druha sada dat, kde delka vektoru je generovana z normalni distribuce podle parametru "mean" a "sigma".
@@ -80,15 +101,10 @@ void generateAndSolveSecondDataSet(TextTable &table) {
 
     //serazeni delek vektoru vzestupne
     //sort(lengths.begin(), lengths.end());
-    vector<vector<int8_t>> data;
-    for (int &j : lengths) {
-        vector<int8_t> vec(static_cast<unsigned long>(j));
-        data.push_back(vec);
-    }
+    FlatData data(lengths);
     vector<long> solution(N);
-    generator.generateData(solution, data);
-    auto results = executor.executeMethods(solution, data);
-    addRowWithResultsToTable("Delky s velkym rozptylem", results, table);
+    generator.generateDataCached("secondDataSet", solution, data);
+    solveDataSet("secondDataSet", "Delky s velkym rozptylem", solution, std::move(data), table);
 }
 
 // Treti sada dat, ktera obsahuje velky pocet vektoru male konstatntni velikost.
@@ -96,25 +112,29 @@ void generateAndSolveSecondDataSet(TextTable &table) {
 // se vypocet v pripade redukce nebude vykonavat paralelne.
 // Proc v tomto pripade muze byt dynamicke rozvrhovani horsi nez staticke?
 void generateAndSolveThirdDataSet(TextTable &table) {
-    vector<vector<int8_t>> data(10000000, vector<int8_t>(2));
+    FlatData data(10000000, 2);
     vector<long> solution(10000000);
-    generator.generateData(solution, data);
-    auto results = executor.executeMethods(solution, data);
-    addRowWithResultsToTable("Hodne kratkych vektoru", results, table);
+    generator.generateDataCached("thirdDataSet", solution, data);
+    solveDataSet("thirdDataSet", "Hodne kratkych vektoru", solution, std::move(data), table);
 }
 
 // Ctvrta sada obsahuje data, ktera jsou nevhodna k paralelizaci. Vektoru je malo a navic jsou
 // velmi kratke. V tomto pripade by mela mit na vrch sekvencni verze, ktera nema zadnou rezii
 // na paralelizaci.
 void generateAndSolveForthDataSet(TextTable &table) {
-    vector<vector<int8_t>> data(10, vector<int8_t>(10));
+    FlatData data(10, 10);
     vector<long> solution(10);
-    generator.generateData(solution, data);
-    auto results = executor.executeMethods(solution, data);
-    addRowWithResultsToTable("Data nevhodna k paralelizaci", results, table);
+    generator.generateDataCached("forthDataSet", solution, data);
+    solveDataSet("forthDataSet", "Data nevhodna k paralelizaci", solution, std::move(data), table);
 }
 
 int main() {
+    // Kalibrace prahu pro sumsOfVectors_auto (pri prvnim spusteni na stroji se zmeri a ulozi)
+    const strategyThresholds_t &thresholds = strategyThresholds();
+    std::cout << "Prahy pro automatickou volbu (" << calibrationFile() << "): sekvencne do "
+              << thresholds.sequentialMaxBytes << " B, redukce uvnitr vektoru od " << thresholds.perVectorMinBytes
+              << " B, nevyvazenost od " << thresholds.skewMaxRatio << "x prumeru" << std::endl;
+
     //vytvor tabulku, parametry jsou znaky pro ohraniceni
     TextTable table('-', '|', '+');
 
@@ -125,6 +145,10 @@ int main() {
     table.add("Reseni s michanim");
     table.add("Reseni s dyn. rozvrhovanim");
     table.add("Reseni se statickym rozvrhovanim");
+    table.add("Souvisle pole + SIMD");
+    table.add("Automaticka volba");
+    table.add("Rozdeleni LPT");
+    table.add("Hybridni (zrychleni)");
     table.endOfRow();
 
     //pro blizsi informace se podivejte na samotne metody s komentarem
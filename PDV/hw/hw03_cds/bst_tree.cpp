@@ -1,57 +1,411 @@
-#include <functional>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include "bst_tree.h"
 
-void bst_tree::insert(long long data) {
-    node * new_node = new node(data);
-    node * current = root;
-    node* tmp = nullptr;
+// Edge marks kept in the low bits of left/right (nodes are at least 8 byte aligned).
+// FLAG: the leaf at the end of the edge is being removed.
+// TAG: the edge must not change anymore, its parent is about to be unlinked.
+static constexpr uintptr_t FLAG = 1;
+static constexpr uintptr_t TAG = 2;
+static constexpr uintptr_t MARKS = FLAG | TAG;
 
-    while(true){
-        if(root == nullptr){
-            if(root.compare_exchange_strong(tmp, new_node)){
-                break;
-            }
+// Below these sizes the batch operations recurse sequentially instead of spawning tasks
+static constexpr size_t SORT_TASK_CUTOFF = 1 << 16;
+static constexpr size_t BUILD_TASK_CUTOFF = 1 << 14;
+static constexpr ptrdiff_t SPLICE_TASK_CUTOFF = 1 << 10;
+
+static inline uintptr_t bits(bst_tree::node * pointer) {
+    return reinterpret_cast<uintptr_t>(pointer);
+}
+
+static inline bool flagged(bst_tree::node * pointer) {
+    return (bits(pointer) & FLAG) != 0;
+}
+
+static inline bool tagged(bst_tree::node * pointer) {
+    return (bits(pointer) & TAG) != 0;
+}
+
+static inline bst_tree::node * with_marks(bst_tree::node * pointer, uintptr_t marks) {
+    return reinterpret_cast<bst_tree::node*>(bits(pointer) | marks);
+}
+
+// std::atomic<T*> has no fetch_or, emulated with CAS. Returns the previous value.
+static inline bst_tree::node * tag_edge(std::atomic<bst_tree::node*> & edge) {
+    bst_tree::node * value = edge.load();
+    while(!edge.compare_exchange_weak(value, with_marks(value, TAG))) {}
+    return value;
+}
+
+static inline bool is_leaf(const bst_tree::node * n) {
+    return n->left.load() == nullptr;
+}
+
+// Out-of-line definitions, create_node takes the sentinels by reference (C++14)
+constexpr long long bst_tree::INF2;
+constexpr long long bst_tree::INF1;
+constexpr long long bst_tree::INF0;
+
+bst_tree::node * bst_tree::address(node * pointer) {
+    return reinterpret_cast<node*>(bits(pointer) & ~MARKS);
+}
+
+template <typename... Args>
+bst_tree::node * bst_tree::create_node(Args &&... args) {
+    if(mode == SLABS) return arena->create(std::forward<Args>(args)...);
+    return new node(std::forward<Args>(args)...);
+}
+
+void bst_tree::discard_node(node * n) {
+    if(n == nullptr) return;
+    if(mode == SLABS) arena->destroy(n);
+    else delete n;
+}
+
+void bst_tree::retire_node(node * n) {
+    if(mode == SLABS) arena->retire(n);
+    else reclaimer::instance().retire(n);
+}
+
+bst_tree::bst_tree(allocation mode) : mode(mode) {
+    if(mode == SLABS) arena = new arena_t();
+
+    // Sentinels: every real key is smaller than INF0, so the real keys always hang below S.left
+    // and the seek record is always fully defined.
+    node * s = create_node(INF1, create_node(INF0), create_node(INF1));
+    root = create_node(INF2, s, create_node(INF2));
+}
+
+void bst_tree::seek(long long key, seek_record & record) const {
+    node * r = root.load();
+    node * s = address(r->left.load());
+
+    record.ancestor = r;
+    record.successor = s;
+    record.parent = s;
+
+    node * parent_field = s->left.load();
+    record.leaf = address(parent_field);
+    record.lower = std::numeric_limits<long long>::min();
+    record.upper = record.leaf->data;
+    node * current_field = record.leaf->left.load();
+    node * current = address(current_field);
+
+    while(current != nullptr) {
+        // The successor is the topmost node of the chain reached over tagged edges
+        if(!tagged(parent_field)) {
+            record.ancestor = record.parent;
+            record.successor = record.leaf;
         }
-        else if(current->data > data){
-            if(current->left == nullptr){
-                if(current->left.compare_exchange_strong(tmp,new_node)){
-                    break;
-                }
-                else{
-                    continue;
-                }
-            }
-            else{
-                current = current->left;
-            }
+        record.parent = record.leaf;
+        record.leaf = current;
+
+        parent_field = current_field;
+        const bool go_left = key < current->data;
+        current_field = go_left ? current->left.load() : current->right.load();
+        // Only internal nodes bound the interval of the leaf
+        if(current_field != nullptr) (go_left ? record.upper : record.lower) = current->data;
+        current = address(current_field);
+    }
+}
+
+bool bst_tree::contains(long long data) const {
+    auto guard = reclaimer::instance().pin();
+    node * current = address(root.load());
+    while(!is_leaf(current)) {
+        current = address(data < current->data ? current->left.load() : current->right.load());
+    }
+    return current->data == data;
+}
+
+bool bst_tree::insert(long long data) {
+    if(data >= INF0) return false;
+    auto guard = reclaimer::instance().pin();
+
+    // Allocated once, reused if the CAS has to be retried
+    node * new_leaf = create_node(data);
+    node * new_internal = nullptr;
+    seek_record record;
+
+    while(true) {
+        seek(data, record);
+        node * leaf = record.leaf;
+        node * parent = record.parent;
+
+        if(leaf->data == data) {
+            discard_node(new_leaf);
+            discard_node(new_internal);
+            return false;
         }
-        else if(current->data < data){
-            if(current->right == nullptr){
-                if(current->right.compare_exchange_strong(tmp,new_node)){
-                    break;
-                }
-                else{
-                    continue;
-                }
-            }
-            else{
-                current = current->right;
+
+        // New internal node with the old leaf and the new one as children
+        if(new_internal == nullptr) new_internal = create_node(0);
+        new_internal->data = std::max(data, leaf->data);
+        new_internal->left = data < leaf->data ? new_leaf : leaf;
+        new_internal->right = data < leaf->data ? leaf : new_leaf;
+
+        std::atomic<node*> & child = data < parent->data ? parent->left : parent->right;
+        node * expected = leaf;
+        if(child.compare_exchange_strong(expected, new_internal)) return true;
+
+        // The edge is marked, help the removal in progress and try again
+        if(address(expected) == leaf && (expected != leaf)) cleanup(data, record);
+    }
+}
+
+bool bst_tree::remove(long long data) {
+    if(data >= INF0) return false;
+    auto guard = reclaimer::instance().pin();
+
+    seek_record record;
+    node * leaf = nullptr;
+    bool injected = false;
+
+    while(true) {
+        seek(data, record);
+        node * parent = record.parent;
+        std::atomic<node*> & child = data < parent->data ? parent->left : parent->right;
+
+        if(!injected) {
+            leaf = record.leaf;
+            if(leaf->data != data) return false;
+
+            // Injection: flag the edge to the leaf, from now on the key is removed
+            node * expected = leaf;
+            if(child.compare_exchange_strong(expected, with_marks(leaf, FLAG))) {
+                injected = true;
+                if(cleanup(data, record)) return true;
+            } else if(address(expected) == leaf && expected != leaf) {
+                cleanup(data, record);
             }
+        } else {
+            // Cleanup: someone else may have unlinked our leaf already
+            if(record.leaf != leaf) return true;
+            if(cleanup(data, record)) return true;
+        }
+    }
+}
+
+bool bst_tree::cleanup(long long key, const seek_record & record) {
+    node * ancestor = record.ancestor;
+    node * successor = record.successor;
+    node * parent = record.parent;
+
+    std::atomic<node*> & successor_edge = key < ancestor->data ? ancestor->left : ancestor->right;
+    std::atomic<node*> * child_edge = key < parent->data ? &parent->left : &parent->right;
+    std::atomic<node*> * sibling_edge = key < parent->data ? &parent->right : &parent->left;
+
+    // The flagged leaf may be on the other side, then the key side is the one that stays
+    if(!flagged(child_edge->load())) std::swap(child_edge, sibling_edge);
+
+    // Freeze the sibling edge, keep a flag that may be on it
+    node * sibling_field = tag_edge(*sibling_edge);
+    node * sibling = address(sibling_field);
+    node * replacement = with_marks(sibling, bits(sibling_field) & FLAG);
+
+    node * expected = successor;
+    if(!successor_edge.compare_exchange_strong(expected, replacement)) return false;
+
+    // Unlinked: the chain of tagged nodes from the successor down to the parent, each with its
+    // flagged leaf. All their edges are marked, so they do not change anymore. Threads still
+    // walking through them are pinned, so they are freed only after those threads move on.
+    for(node * current = successor; current != parent; ) {
+        node * left = current->left.load();
+        node * right = current->right.load();
+        node * next = key < current->data ? left : right;
+        retire_node(address(key < current->data ? right : left));
+        retire_node(current);
+        current = address(next);
+    }
+    retire_node(address(child_edge->load()));
+    retire_node(parent);
+    return true;
+}
+
+// Sorted new keys [first, last) merged with the existing leaf they all land in. The leaf keeps its
+// position in the sequence; if it already holds one of the keys, it stands in for that key.
+class bst_tree::leaf_merge {
+public:
+    const long long * keys;
+    node * leaf;
+    size_t at;                  // Position of the leaf in the merged sequence
+    bool duplicate;
+    size_t count;               // Length of the merged sequence
+
+    leaf_merge(const long long * first, const long long * last, node * leaf) : keys(first), leaf(leaf) {
+        at = static_cast<size_t>(std::lower_bound(first, last, leaf->data) - first);
+        duplicate = first + at != last && first[at] == leaf->data;
+        count = static_cast<size_t>(last - first) + (duplicate ? 0 : 1);
+    }
+
+    long long key(size_t i) const {
+        if(i < at) return keys[i];
+        if(i == at) return leaf->data;
+        return keys[duplicate ? i : i - 1];
+    }
+
+    // Number of keys that are not in the tree yet
+    size_t fresh() const {
+        return count - 1;
+    }
+};
+
+// Balanced external subtree over the merged sequence [begin, end). Each internal node carries the
+// smallest key of its right subtree, as insert would have set it.
+bst_tree::node * bst_tree::build(const leaf_merge & keys, size_t begin, size_t end) {
+    if(end - begin == 1) return begin == keys.at ? keys.leaf : create_node(keys.key(begin));
+
+    const size_t middle = begin + (end - begin) / 2;
+    node * left;
+    node * right;
+    if(end - begin > BUILD_TASK_CUTOFF) {
+        #pragma omp task shared(left, keys)
+        left = build(keys, begin, middle);
+        right = build(keys, middle, end);
+        #pragma omp taskwait
+    } else {
+        left = build(keys, begin, middle);
+        right = build(keys, middle, end);
+    }
+    return create_node(keys.key(middle), left, right);
+}
+
+// Frees a subtree that was never published, except the existing leaf it was built around
+void bst_tree::discard_subtree(node * n, const node * keep) {
+    std::vector<node*> stack { n };
+    while(!stack.empty()) {
+        node * current = stack.back();
+        stack.pop_back();
+        if(current == keep) continue;
+        if(!is_leaf(current)) {
+            stack.push_back(current->left.load());
+            stack.push_back(current->right.load());
+        }
+        discard_node(current);
+    }
+}
+
+// All keys of [first, last) land in record.leaf: replace the leaf with a subtree holding the keys
+// and the leaf itself, using a single CAS at its parent.
+size_t bst_tree::splice_group(const long long * first, const long long * last, const seek_record & record) {
+    node * leaf = record.leaf;
+    node * parent = record.parent;
+    leaf_merge keys(first, last, leaf);
+    if(keys.fresh() == 0) return 0;
+
+    // The INF0 leaf stays the right child of an internal INF0 node right below S, seek relies on it
+    node * subtree = leaf->data == INF0 ? create_node(INF0, build(keys, 0, keys.count - 1), leaf)
+                                        : build(keys, 0, keys.count);
+    std::atomic<node*> & child = *first < parent->data ? parent->left : parent->right;
+    node * expected = leaf;
+    if(child.compare_exchange_strong(expected, subtree)) return keys.fresh();
+
+    // The leaf changed in the meantime: throw the subtree away, help a removal in progress and
+    // split the keys again against the current tree
+    discard_subtree(subtree, leaf);
+    if(address(expected) == leaf && expected != leaf) cleanup(*first, record);
+    return splice_range(first, last);
+}
+
+// Sorted distinct keys below INF0. The middle key finds its leaf, every key from the same leaf
+// interval is spliced in with it, and the keys on both sides are handled as independent tasks.
+// Concurrent updates can only narrow the leaf interval by replacing the leaf, which fails the CAS.
+size_t bst_tree::splice_range(const long long * first, const long long * last) {
+    if(first == last) return 0;
+
+    const long long * middle = first + (last - first) / 2;
+    size_t left = 0, right = 0, here = 0;
+    {
+        auto guard = reclaimer::instance().pin();
+        seek_record record;
+        seek(*middle, record);
+        const long long * group_first = std::lower_bound(first, middle, record.lower);
+        const long long * group_last = std::lower_bound(middle, last, record.upper);
+
+        if(group_first - first > SPLICE_TASK_CUTOFF) {
+            #pragma omp task shared(left)
+            left = splice_range(first, group_first);
+        } else {
+            left = splice_range(first, group_first);
+        }
+        if(last - group_last > SPLICE_TASK_CUTOFF) {
+            #pragma omp task shared(right)
+            right = splice_range(group_last, last);
+        } else {
+            right = splice_range(group_last, last);
         }
+        here = splice_group(group_first, group_last, record);
+    }
+    #pragma omp taskwait
+    return left + here + right;
+}
+
+static void parallel_sort(long long * first, long long * last) {
+    if(static_cast<size_t>(last - first) <= SORT_TASK_CUTOFF) {
+        std::sort(first, last);
+        return;
     }
-    // Naimplementujte zde vlaknove-bezpecne vlozeni do binarniho vyhledavaciho stromu
+    long long * middle = first + (last - first) / 2;
+    #pragma omp task
+    parallel_sort(first, middle);
+    parallel_sort(middle, last);
+    #pragma omp taskwait
+    std::inplace_merge(first, middle, last);
+}
+
+size_t bst_tree::insert_batch(const long long * first, const long long * last) {
+    std::vector<long long> keys(first, last);
+    #pragma omp parallel
+    #pragma omp single
+    parallel_sort(keys.data(), keys.data() + keys.size());
+
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    keys.erase(std::lower_bound(keys.begin(), keys.end(), INF0), keys.end());
+    return bulk_load(keys.data(), keys.data() + keys.size());
+}
+
+size_t bst_tree::bulk_load(const long long * first, const long long * last) {
+    if(first == last) return 0;
+
+    bool ordered = last[-1] < INF0;
+    const long long count = last - first;
+    #pragma omp parallel for reduction(&&:ordered)
+    for(long long i = 1 ; i < count ; i++) {
+        if(first[i - 1] >= first[i]) ordered = false;
+    }
+    if(!ordered) return insert_batch(first, last);
+
+    size_t inserted = 0;
+    #pragma omp parallel
+    #pragma omp single
+    inserted = splice_range(first, last);
+    return inserted;
 }
 
 bst_tree::~bst_tree() {
-    // Rekurzivni funkce pro pruchod stromu a dealokaci pameti prirazene jednotlivym
-    // uzlum
-    std::function<void(node*)> cleanup = [&](node * n) {
-        if(n != nullptr) {
-            cleanup(n->left);
-            cleanup(n->right);
-
-            delete n;
+    if(mode == SLABS) {
+        // Vsechny uzly lezi ve slabech areny, strom neni treba prochazet. Nejprve se vrati
+        // vypojene uzly z reclaimeru, pak se slaby uvolni najednou.
+        reclaimer::instance().flush();
+        arena->release();
+        return;
+    }
+
+    // Pruchod stromu a dealokace pameti prirazene jednotlivym uzlum. Iterativne, protoze
+    // pri serazenem vkladani je strom hluboky jako pocet prvku.
+    std::vector<node*> stack;
+    if(root.load() != nullptr) stack.push_back(address(root.load()));
+    while(!stack.empty()) {
+        node * n = stack.back();
+        stack.pop_back();
+        if(!is_leaf(n)) {
+            stack.push_back(address(n->left.load()));
+            stack.push_back(address(n->right.load()));
         }
-    };
-    cleanup(root);
+        delete n;
+    }
+
+    // Vypojene uzly uz nejsou ze stromu dosazitelne, uvolni se pres reclaimer
+    reclaimer::instance().flush();
 }
@@ -2,9 +2,24 @@
 #define PDV_HW03_BST_H
 
 #include <atomic>
+#include <limits>
+#include <vector>
+#include <cstdint>
 
+#include "reclamation.h"
+#include "slab_arena.h"
+
+// Lock-free binarni vyhledavaci strom podle Natarajan a Mittal, "Fast Concurrent Lock-Free Binary
+// Search Trees" (PPoPP 2014). Strom je externi: hodnoty jsou jen v listech, vnitrni uzly slouzi
+// k navigaci (v levem podstromu jsou hodnoty mensi nez data uzlu, v pravem vetsi nebo rovne).
+// Mazani je dvoufazove - hrana k mazanemu listu se oznaci priznakem (flag), hrana k jeho sourozenci
+// se zamkne (tag) a pak se cela dvojice vypoji jednim CAS u predka.
 class bst_tree {
 public:
+    // Vypojene uzly uvolnuje epoch-based reclamation. Hazard pointers tu pouzit nejdou: hledani
+    // prochazi i pres uz vypojene (oznacene) uzly, jejichz hrany se nemeni, takze by kontrola
+    // po zverejneni ukazatele neodhalila, ze potomek mezitim mohl byt uvolnen.
+    typedef reclamation::epoch reclaimer;
 
     // Trida node reprezentuje uzel binarniho vyhledavaciho stromu. Definici teto tridy si
     // muzete upravit, zachovejte ale prosim clenske promenne left, right (pointery, ktere
@@ -15,22 +30,109 @@ public:
         std::atomic<node*> right { nullptr };    // Ukazatel na koren praveho podstromu
         // Pro pripomenuti: V binarnim vyhledavacim strome jsou uzly s nizsi hodnotou v levem
         // podstromu a uzly s vyssi hodnotou v pravem podstromu.
+        // Ukazatele mohou mit v nejnizsich bitech priznaky FLAG a TAG, viz bst_tree.cpp.
 
         long long data;              // Hodnota aktualniho uzlu
 
         // Konstruktor, ktery nastavi hodnotu aktualniho uzlu
         node(long long data) : data(data) {}
+
+        node(long long data, node * left, node * right) : left(left), right(right), data(data) {}
     };
 
-    // Ukazatel na koren stromu
+    // Tri nejvyssi hodnoty jsou vyhrazene pro zarazky, do stromu lze vkladat jen hodnoty mensi nez INF0
+    static constexpr long long INF2 = std::numeric_limits<long long>::max();
+    static constexpr long long INF1 = INF2 - 1;
+    static constexpr long long INF0 = INF2 - 2;
+
+    // Ukazatel na koren stromu (vnitrni uzel se zarazkou INF2, nikdy se nemeni)
     std::atomic<node*> root { nullptr };
 
+    // Odkud se berou uzly: SLABS = slab_arena (bloky po vlaknech, strom se rusi po celych blocich),
+    // HEAP = new/delete pro kazdy uzel (puvodni chovani, pro srovnani)
+    enum allocation { SLABS, HEAP };
+
+    explicit bst_tree(allocation mode = SLABS);
+
+    bst_tree(const bst_tree &) = delete;
+    bst_tree & operator=(const bst_tree &) = delete;
+
     // Destruktor stromu, ktery uvolni alokovanou pamet
     ~bst_tree();
 
-    // Metoda pro vkladani prvku do binarniho vyhledavaciho stromu, kterou budete implementovat
-    void insert(long long data);
+    // Vlozi hodnotu do stromu, vraci false, pokud uz ve strome je
+    bool insert(long long data);
+
+    // Odebere hodnotu ze stromu, vraci false, pokud ve strome neni
+    bool remove(long long data);
+
+    // Je hodnota ve strome? Pouze cte, nikdy nezapisuje ani neceka na ostatni vlakna.
+    bool contains(long long data) const;
+
+    // Vlozi davku hodnot (v libovolnem poradi, i s duplicitami), vraci pocet nove vlozenych.
+    // Davka se seradi a klice, ktere padnou do stejneho listu, se z nej postavi jako vyvazeny
+    // podstrom a pripoji jedinym CAS. Prace se deli mezi OpenMP tasky, smi bezet soucasne
+    // s ostatnimi operacemi.
+    size_t insert_batch(const long long * first, const long long * last);
+
+    // Jako insert_batch pro serazenou posloupnost bez duplicit, kterou nekopiruje ani neradi.
+    // Do prazdneho stromu tak paralelne postavi dokonale vyvazeny strom jedinym CAS.
+    // Neserazeny vstup se preda insert_batch.
+    size_t bulk_load(const long long * first, const long long * last);
+
+    // Projde hodnoty stromu vzestupne (bez zarazek). Neni vlaknove bezpecne, slouzi pro kontrolu
+    // vysledku po skonceni paralelni casti.
+    template <typename F>
+    void for_each(F f) const;
+
+private:
+    struct seek_record {
+        node * ancestor;
+        node * successor;
+        node * parent;
+        node * leaf;
+        long long lower, upper;            // Do listu vedou prave klice z intervalu [lower, upper)
+    };
+
+    typedef slab_arena<node, reclaimer> arena_t;
+
+    const allocation mode;
+    arena_t * arena = nullptr;              // Jen pro SLABS, patri stromu a vypojenym uzlum
+
+    template <typename... Args>
+    node * create_node(Args &&... args);
+    void discard_node(node * n);            // Uzel, ktery nikdy nebyl ve strome
+    void retire_node(node * n);             // Vypojeny uzel
+
+    void seek(long long key, seek_record & record) const;
+    bool cleanup(long long key, const seek_record & record);
+
+    // Hromadne vkladani serazenych klicu bez duplicit, viz bst_tree.cpp
+    class leaf_merge;
+    size_t splice_range(const long long * first, const long long * last);
+    size_t splice_group(const long long * first, const long long * last, const seek_record & record);
+    node * build(const leaf_merge & keys, size_t begin, size_t end);
+    void discard_subtree(node * n, const node * keep);
+
+    static node * address(node * pointer);
 };
 
+template <typename F>
+void bst_tree::for_each(F f) const {
+    // Iterativni inorder pruchod, strom muze byt pri serazenem vkladani hodne hluboky
+    std::vector<node*> stack;
+    node * current = address(root.load());
+    while(current != nullptr || !stack.empty()) {
+        while(current != nullptr) {
+            stack.push_back(current);
+            current = address(current->left.load());
+        }
+        current = stack.back();
+        stack.pop_back();
+        const bool leaf = address(current->left.load()) == nullptr;
+        if(leaf && current->data < INF0) f(current->data);
+        current = address(current->right.load());
+    }
+}
 
 #endif //PDV_HW03_BST_H
@@ -1,35 +1,47 @@
 #include <cstdio>
 #include <chrono>
 #include <string>
+#include <memory>
 
 #include "tests.h"
 
 constexpr unsigned int N1 = 1000000;      // Kolik prvku budeme do BVS vkladat "napreskacku"
 constexpr unsigned int N2 = 40000;         // Kolik prvku budeme do BVS vkladat "poporade"
+constexpr unsigned int N3 = 4000000;       // Kolik smisenych operaci (hledani, vkladani, mazani) provedeme
+constexpr unsigned int N4 = 4000000;       // Kolik dvojic vlozeni a odebrani provedeme pri testu uvolnovani pameti
+constexpr unsigned int N5 = 10000000;      // Kolik prvku budeme vkladat do skip listu (v obou poradich)
+constexpr unsigned int N6 = 20000000;      // Kolik prvku budeme do BVS vkladat hromadne (bulk_load, insert_batch)
 
 // Tato metoda spousti test definovany ve tride Test (implementaci testu si muzete prohlednout
-// ve tride tests.h).
+// ve tride tests.h). Meri se i zruseni testu, tj. uvolneni cele struktury.
 template <typename Test>
 void run_test(std::string test_name) {
     using namespace std::chrono;
 
     // Nejprve si vytvorime instanci testu
-    Test test;
+    std::unique_ptr<Test> test(new Test());
 
     try {
         // Cas zacatku behu testu
         auto begin = steady_clock::now();
         // Beh testu
-        test.run_test();
+        test->run_test();
         // Konec behu testu
         auto end = steady_clock::now();
 
         // Kontrola spravnosti vysledku
-        if(!test.verify()) {
+        const bool correct = test->verify();
+
+        auto teardown_begin = steady_clock::now();
+        test.reset();
+        auto teardown_end = steady_clock::now();
+
+        if(!correct) {
             printf("%s       --- wrong result ---\n", test_name.c_str());
         } else {
-            printf("%s          %7ldms\n", test_name.c_str(), 
-				static_cast<long>(duration_cast<milliseconds>(end-begin).count()));
+            printf("%s          %7ldms   (teardown %ldms)\n", test_name.c_str(),
+				static_cast<long>(duration_cast<milliseconds>(end-begin).count()),
+				static_cast<long>(duration_cast<milliseconds>(teardown_end-teardown_begin).count()));
         }
     } catch(...) {
         printf("%s      --- not implemented ---\n", test_name.c_str());
@@ -37,10 +49,23 @@ void run_test(std::string test_name) {
 }
 
 int main() {
-    // Test vkladani do BST "napreskacku"
+    // Test vkladani do BST "napreskacku", uzly z haldy po jednom a ze slabu (vychozi)
+    run_test<shuffled_data<N1, bst_tree_heap>>("Shuffled heap");
     run_test<shuffled_data<N1>>("Shuffled data");
+    // Hromadne vkladani: serazeny vektor najednou a zamichany po davkach
+    run_test<bulk_loaded<N6>>   ("Bulk load    ");
+    run_test<batched_insert<N6>>("Batch insert ");
     // Test vkladani do BST "poporade"
     run_test<sorted_data<N2>>  ("Sorted data  ");
+    // Smisene operace nad predplnenym stromem (80 % hledani, 10 % vkladani, 10 % mazani)
+    run_test<mixed_operations<N3>>("Mixed ops    ");
+    // Neustale vkladani a mazani, pamet vypojenych uzlu se musi prubezne uvolnovat
+    run_test<reclamation_churn<N4>>("Reclamation  ");
+    printf("Peak retired, not yet freed    %7lldkB\n", reclamation_churn<N4>::peak_retired_bytes() / 1024);
+
+    // Skip list nezavisi na poradi vkladani, zvladne proto i serazena data v plne velikosti
+    run_test<shuffled_data<N5, skip_list>>("Skip list shuffled");
+    run_test<sorted_data<N5, skip_list>>  ("Skip list sorted  ");
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,426 @@
+#ifndef PDV_HW03_RECLAMATION_H
+#define PDV_HW03_RECLAMATION_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+// Bezpecne uvolnovani pameti pro lock-free struktury. Uzel vypojeny ze struktury muze jine vlakno
+// jeste prochazet, proto se misto delete preda metode retire() a uvolni se, az ho nikdo drzet nemuze.
+//
+// Obe schemata maji stejne rozhrani, struktura je muze mit jako typovy parametr:
+//
+//     auto guard = reclaimer::instance().pin();      // kriticka sekce, uzly se v ni neuvolni
+//     node * n = guard.protect(0, head);             // nacteni ukazatele (u hazard pointers do slotu 0)
+//     guard.publish(1, n);                           // presun chraneneho ukazatele do jineho slotu
+//     reclaimer::instance().retire(n);               // n uz neni ze struktury dosazitelny
+//
+//   epoch   - epoch-based reclamation: levne pin/unpin, uzly se uvolni po dvou posunech globalni epochy.
+//             Zaseknute vlakno v kriticke sekci zastavi uvolnovani vseho.
+//   hazard  - hazard pointers: kazde vlakno zverejni nejvyse SLOTS ukazatelu, ktere prave pouziva.
+//             Pamet ceka na uvolneni omezene, ale kazdy protect() stoji zapis a fence.
+//
+// Ukazatele mohou mit v nejnizsich 3 bitech priznaky, chrani se adresa bez nich. Kazde vlakno si pri
+// prvnim pouziti zabere jeden z MAX_THREADS zaznamu, pri ukonceni vlakna se zaznam uvolni a jeho
+// neuvolnene uzly prevezme domena.
+namespace reclamation {
+
+constexpr unsigned MAX_THREADS = 256;
+
+struct retired_ptr {
+    void * pointer;
+    void (*deleter)(void *);
+    size_t bytes;
+    uint64_t epoch;             // Epocha vypojeni (jen pro epoch)
+};
+
+template <typename T>
+void delete_as(void * pointer) {
+    delete static_cast<T*>(pointer);
+}
+
+inline const void * strip(const void * pointer) {
+    return reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(pointer) & ~static_cast<uintptr_t>(7));
+}
+
+// Kolik bajtu je vypojenych a jeste neuvolnenych, a nejvic kolik jich kdy bylo. Aktualizuje se pri
+// kazdem sberu, ne pri kazdem retire(), aby citac nebyl sdilene horke misto.
+class statistics {
+    std::atomic<long long> pending { 0 };
+    std::atomic<long long> peak { 0 };
+
+public:
+    void add(long long bytes) {
+        const long long now = pending.fetch_add(bytes) + bytes;
+        long long seen = peak.load();
+        while(now > seen && !peak.compare_exchange_weak(seen, now)) {}
+    }
+
+    void remove(long long bytes) { pending.fetch_sub(bytes); }
+
+    long long pending_bytes() const { return pending.load(); }
+
+    long long peak_bytes() const { return peak.load(); }
+
+    void reset_peak() { peak.store(pending.load()); }
+};
+
+// Pevne pole zaznamu vlaken, zaznamy se nikdy neuvolnuji, takze je lze prochazet bez zamku
+template <typename record_t>
+class registry {
+    record_t records[MAX_THREADS];
+    std::atomic<unsigned> used { 0 };       // Zaznamy s vyssim indexem nikdy nikdo nepouzil
+
+public:
+    record_t * acquire() {
+        for(unsigned i = 0 ; i < MAX_THREADS ; i++) {
+            bool expected = false;
+            if(!records[i].in_use.load() && records[i].in_use.compare_exchange_strong(expected, true)) {
+                unsigned seen = used.load();
+                while(seen < i + 1 && !used.compare_exchange_weak(seen, i + 1)) {}
+                return &records[i];
+            }
+        }
+        throw std::runtime_error("reclamation: too many threads");
+    }
+
+    void release(record_t * record) { record->in_use.store(false); }
+
+    template <typename F>
+    void for_each(F f) {
+        const unsigned n = used.load();
+        for(unsigned i = 0 ; i < n ; i++) {
+            if(records[i].in_use.load()) f(records[i]);
+        }
+    }
+
+    unsigned size() const { return used.load(); }
+};
+
+
+class epoch {
+    struct alignas(64) record {
+        std::atomic<bool> in_use { false };
+        // (epocha << 1) | 1 v kriticke sekci, 0 mimo ni
+        std::atomic<uint64_t> announced { 0 };
+        unsigned nesting = 0;
+        std::vector<retired_ptr> retired;
+        size_t next_collect = 0;            // Dalsi sber az pri teto delce seznamu retired
+        long long unaccounted = 0;          // Bajty vypojene od posledniho sberu
+    };
+
+    static constexpr size_t COLLECT_THRESHOLD = 128;
+
+    std::atomic<uint64_t> global { 0 };
+    registry<record> threads;
+    statistics stats;
+
+    // Uzly po skoncenych vlaknech
+    std::mutex mtx_orphans;
+    std::vector<retired_ptr> orphans;
+
+    epoch() = default;
+
+    struct handle {
+        epoch & domain;
+        record * own;
+        explicit handle(epoch & domain) : domain(domain), own(domain.threads.acquire()) {}
+        ~handle() { domain.release(*own); }
+    };
+
+    record & local() {
+        thread_local handle h(*this);
+        return *h.own;
+    }
+
+    void enter(record & r) {
+        if(r.nesting++ == 0) {
+            r.announced.exchange((global.load() << 1) | 1);
+        }
+    }
+
+    void leave(record & r) {
+        if(--r.nesting == 0) r.announced.store(0, std::memory_order_release);
+    }
+
+    // Posune globalni epochu, pokud ji vsechna vlakna v kriticke sekci uz videla
+    bool try_advance() {
+        const uint64_t current = global.load();
+        bool behind = false;
+        threads.for_each([&](record & r) {
+            const uint64_t seen = r.announced.load();
+            if((seen & 1) != 0 && (seen >> 1) != current) behind = true;
+        });
+        if(behind) return false;
+        uint64_t expected = current;
+        return global.compare_exchange_strong(expected, current + 1) || expected != current;
+    }
+
+    // Uvolni uzly vypojene alespon o dve epochy drive, zbytek ponecha v seznamu
+    void free_expired(std::vector<retired_ptr> & list) {
+        const uint64_t current = global.load();
+        long long freed = 0;
+        auto keep = std::partition(list.begin(), list.end(),
+                                   [&](const retired_ptr & p) { return p.epoch + 2 > current; });
+        for(auto it = keep ; it != list.end() ; ++it) {
+            it->deleter(it->pointer);
+            freed += static_cast<long long>(it->bytes);
+        }
+        list.erase(keep, list.end());
+        stats.remove(freed);
+    }
+
+    void collect(record & r) {
+        stats.add(r.unaccounted);
+        r.unaccounted = 0;
+        try_advance();
+        free_expired(r.retired);
+        // Co se ted uvolnit nepodarilo, nebude se prochazet pri kazdem dalsim retire()
+        r.next_collect = r.retired.size() + COLLECT_THRESHOLD;
+
+        std::unique_lock<std::mutex> lck(mtx_orphans, std::try_to_lock);
+        if(lck.owns_lock() && !orphans.empty()) free_expired(orphans);
+    }
+
+    void release(record & r) {
+        stats.add(r.unaccounted);
+        r.unaccounted = 0;
+        {
+            std::lock_guard<std::mutex> lck(mtx_orphans);
+            orphans.insert(orphans.end(), r.retired.begin(), r.retired.end());
+        }
+        r.retired.clear();
+        r.nesting = 0;
+        r.announced.store(0);
+        threads.release(&r);
+    }
+
+public:
+    class guard {
+        epoch * domain;
+        record * own;
+
+    public:
+        guard(epoch * domain, record * own) : domain(domain), own(own) {}
+        guard(guard && other) noexcept : domain(other.domain), own(other.own) { other.domain = nullptr; }
+        guard(const guard &) = delete;
+        guard & operator=(const guard &) = delete;
+        ~guard() { if(domain != nullptr) domain->leave(*own); }
+
+        template <typename T>
+        T * protect(unsigned, const std::atomic<T*> & source) const { return source.load(std::memory_order_acquire); }
+
+        void publish(unsigned, const void *) const {}
+    };
+
+    // Domena je jedina na proces a nikdy se nerusi (vlakna OpenMP mohou koncit az po statickych
+    // objektech). Vytvari se ve statickem poli, protoze C++14 neumi new se zarovnanim na 64 B.
+    static epoch & instance() {
+        alignas(epoch) static unsigned char storage[sizeof(epoch)];
+        static epoch * domain = new(storage) epoch();
+        return *domain;
+    }
+
+    guard pin() {
+        record & r = local();
+        enter(r);
+        return guard(this, &r);
+    }
+
+    template <typename T>
+    void retire(T * pointer) {
+        retire(pointer, &delete_as<T>, sizeof(T));
+    }
+
+    // Uzel, ktery se neuvolnuje pres delete (napr. patri do slab_arena)
+    void retire(void * pointer, void (*deleter)(void *), size_t bytes) {
+        record & r = local();
+        r.retired.push_back({pointer, deleter, bytes, global.load()});
+        r.unaccounted += static_cast<long long>(bytes);
+        if(r.retired.size() >= std::max<size_t>(r.next_collect, size_t(COLLECT_THRESHOLD))) collect(r);
+    }
+
+    // Uvolni co nejvic uzlu volajiciho vlakna a po skoncenych vlaknech. Volat mimo kriticke sekce.
+    void flush() {
+        record & r = local();
+        stats.add(r.unaccounted);
+        r.unaccounted = 0;
+        try_advance();
+        try_advance();
+        free_expired(r.retired);
+        std::lock_guard<std::mutex> lck(mtx_orphans);
+        free_expired(orphans);
+    }
+
+    const statistics & memory() const { return stats; }
+
+    statistics & memory() { return stats; }
+};
+
+
+class hazard {
+public:
+    static constexpr unsigned SLOTS = 4;
+
+private:
+    struct alignas(64) record {
+        std::atomic<bool> in_use { false };
+        std::atomic<const void*> slots[SLOTS] = {};
+        unsigned nesting = 0;
+        std::vector<retired_ptr> retired;
+        size_t next_collect = 0;
+        long long unaccounted = 0;
+    };
+
+    registry<record> threads;
+    statistics stats;
+
+    std::mutex mtx_orphans;
+    std::vector<retired_ptr> orphans;
+
+    hazard() = default;
+
+    struct handle {
+        hazard & domain;
+        record * own;
+        explicit handle(hazard & domain) : domain(domain), own(domain.threads.acquire()) {}
+        ~handle() { domain.release(*own); }
+    };
+
+    record & local() {
+        thread_local handle h(*this);
+        return *h.own;
+    }
+
+    void leave(record & r) {
+        if(--r.nesting == 0) {
+            for(auto & slot : r.slots) slot.store(nullptr, std::memory_order_release);
+        }
+    }
+
+    // Prah pro sber roste s poctem vlaken, aby byl jeden sber amortizovan mnoha retire()
+    size_t threshold() const {
+        return std::max<size_t>(64, 2 * SLOTS * threads.size());
+    }
+
+    void free_unprotected(std::vector<retired_ptr> & list) {
+        std::vector<const void*> protected_pointers;
+        threads.for_each([&](record & r) {
+            for(auto & slot : r.slots) {
+                const void * p = slot.load();
+                if(p != nullptr) protected_pointers.push_back(p);
+            }
+        });
+        std::sort(protected_pointers.begin(), protected_pointers.end());
+
+        long long freed = 0;
+        auto keep = std::partition(list.begin(), list.end(), [&](const retired_ptr & p) {
+            return std::binary_search(protected_pointers.begin(), protected_pointers.end(), p.pointer);
+        });
+        for(auto it = keep ; it != list.end() ; ++it) {
+            it->deleter(it->pointer);
+            freed += static_cast<long long>(it->bytes);
+        }
+        list.erase(keep, list.end());
+        stats.remove(freed);
+    }
+
+    void collect(record & r) {
+        stats.add(r.unaccounted);
+        r.unaccounted = 0;
+        free_unprotected(r.retired);
+        r.next_collect = r.retired.size() + threshold();
+
+        std::unique_lock<std::mutex> lck(mtx_orphans, std::try_to_lock);
+        if(lck.owns_lock() && !orphans.empty()) free_unprotected(orphans);
+    }
+
+    void release(record & r) {
+        stats.add(r.unaccounted);
+        r.unaccounted = 0;
+        for(auto & slot : r.slots) slot.store(nullptr);
+        {
+            std::lock_guard<std::mutex> lck(mtx_orphans);
+            orphans.insert(orphans.end(), r.retired.begin(), r.retired.end());
+        }
+        r.retired.clear();
+        r.nesting = 0;
+        threads.release(&r);
+    }
+
+public:
+    class guard {
+        hazard * domain;
+        record * own;
+
+    public:
+        guard(hazard * domain, record * own) : domain(domain), own(own) {}
+        guard(guard && other) noexcept : domain(other.domain), own(other.own) { other.domain = nullptr; }
+        guard(const guard &) = delete;
+        guard & operator=(const guard &) = delete;
+        ~guard() { if(domain != nullptr) domain->leave(*own); }
+
+        // Nacte ukazatel a zverejni ho ve slotu. Opakuje, dokud se zdroj mezi nactenim a zverejnenim
+        // nezmenil - jinak uz mohl byt uzel vypojen a uvolnen.
+        template <typename T>
+        T * protect(unsigned slot, const std::atomic<T*> & source) const {
+            T * pointer = source.load();
+            while(true) {
+                own->slots[slot].store(strip(pointer));
+                T * again = source.load();
+                if(again == pointer) return pointer;
+                pointer = again;
+            }
+        }
+
+        // Zverejni ukazatel, ktery uz je chraneny jinym slotem
+        void publish(unsigned slot, const void * pointer) const {
+            own->slots[slot].store(strip(pointer));
+        }
+    };
+
+    static hazard & instance() {
+        alignas(hazard) static unsigned char storage[sizeof(hazard)];
+        static hazard * domain = new(storage) hazard();
+        return *domain;
+    }
+
+    // Vnorene guardy sdileji sloty, sloty se vynuluji az pri opusteni vnejsiho
+    guard pin() {
+        record & r = local();
+        r.nesting++;
+        return guard(this, &r);
+    }
+
+    template <typename T>
+    void retire(T * pointer) {
+        retire(pointer, &delete_as<T>, sizeof(T));
+    }
+
+    void retire(void * pointer, void (*deleter)(void *), size_t bytes) {
+        record & r = local();
+        r.retired.push_back({pointer, deleter, bytes, 0});
+        r.unaccounted += static_cast<long long>(bytes);
+        if(r.retired.size() >= std::max(r.next_collect, threshold())) collect(r);
+    }
+
+    void flush() {
+        record & r = local();
+        collect(r);
+        std::lock_guard<std::mutex> lck(mtx_orphans);
+        free_unprotected(orphans);
+    }
+
+    const statistics & memory() const { return stats; }
+
+    statistics & memory() { return stats; }
+};
+
+} // namespace reclamation
+
+#endif //PDV_HW03_RECLAMATION_H
@@ -0,0 +1,110 @@
+#include <new>
+#include <random>
+#include <thread>
+#include <functional>
+#include "skip_list.h"
+
+skip_list::node * skip_list::node::create(long long data, int height) {
+    // The node is followed by the rest of its next[] array
+    void * memory = ::operator new(sizeof(node) + (height - 1) * sizeof(std::atomic<node*>));
+    node * n = new(memory) node(data, height);
+    for(int level = 1 ; level < height ; level++) new(&n->next[level]) std::atomic<node*>(nullptr);
+    n->next[0].store(nullptr, std::memory_order_relaxed);
+    return n;
+}
+
+void skip_list::node::destroy(node * n) {
+    n->~node();
+    ::operator delete(n);
+}
+
+// Geometric height with p = 1/2 from a per-thread generator
+static int random_height() {
+    thread_local std::minstd_rand rnd(static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    unsigned bits = static_cast<unsigned>(rnd()) | (1U << (skip_list::MAX_LEVEL - 2));
+    int height = 1;
+    for(; (bits & 1) == 0 ; bits >>= 1) height++;
+    return height;
+}
+
+skip_list::skip_list() : head(node::create(std::numeric_limits<long long>::min(), MAX_LEVEL)) {}
+
+skip_list::~skip_list() {
+    node * n = head;
+    while(n != nullptr) {
+        node * next = n->next[0].load();
+        node::destroy(n);
+        n = next;
+    }
+}
+
+bool skip_list::find(long long data, node ** preds, node ** succs) const {
+    const int top = levels.load();
+    for(int level = MAX_LEVEL - 1 ; level >= top ; level--) {
+        preds[level] = head;
+        succs[level] = nullptr;
+    }
+
+    node * pred = head;
+    for(int level = top - 1 ; level >= 0 ; level--) {
+        node * current = pred->next[level].load();
+        while(current != nullptr && current->data < data) {
+            pred = current;
+            current = current->next[level].load();
+        }
+        preds[level] = pred;
+        succs[level] = current;
+    }
+    return succs[0] != nullptr && succs[0]->data == data;
+}
+
+bool skip_list::contains(long long data) const {
+    node * pred = head;
+    node * current = nullptr;
+    for(int level = levels.load() - 1 ; level >= 0 ; level--) {
+        current = pred->next[level].load();
+        while(current != nullptr && current->data < data) {
+            pred = current;
+            current = current->next[level].load();
+        }
+    }
+    return current != nullptr && current->data == data;
+}
+
+bool skip_list::insert(long long data) {
+    node * preds[MAX_LEVEL];
+    node * succs[MAX_LEVEL];
+    node * new_node = nullptr;
+
+    while(true) {
+        if(find(data, preds, succs)) {
+            if(new_node != nullptr) node::destroy(new_node);
+            return false;
+        }
+
+        if(new_node == nullptr) {
+            new_node = node::create(data, random_height());
+            int seen = levels.load();
+            while(seen < new_node->height && !levels.compare_exchange_weak(seen, new_node->height)) {}
+        }
+        for(int level = 0 ; level < new_node->height ; level++) {
+            new_node->next[level].store(succs[level], std::memory_order_relaxed);
+        }
+
+        // Linking the bottom level is the linearization point, the node is in the set from now on
+        node * expected = succs[0];
+        if(!preds[0]->next[0].compare_exchange_strong(expected, new_node)) continue;
+
+        // Upper levels are only shortcuts. Nothing is ever removed, so after a failed CAS it is
+        // enough to look the neighbours up again.
+        for(int level = 1 ; level < new_node->height ; level++) {
+            while(true) {
+                expected = succs[level];
+                if(preds[level]->next[level].compare_exchange_strong(expected, new_node)) break;
+                find(data, preds, succs);
+                new_node->next[level].store(succs[level]);
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef PDV_HW03_SKIP_LIST_H
+#define PDV_HW03_SKIP_LIST_H
+
+#include <atomic>
+#include <vector>
+#include <limits>
+
+// Lock-free skip list (Herlihy, Shavit: "The Art of Multiprocessor Programming", kap. 14) jako
+// alternativa k bst_tree. Vyska kazdeho uzlu je nahodna (na dalsi uroven postoupi s pravdepodobnosti
+// 1/2), takze hledani i vkladani maji ocekavanou slozitost O(log n) bez ohledu na poradi vkladani -
+// na rozdil od nevyvazeneho stromu, ktery pri serazenych datech zdegeneruje na seznam.
+// Podporuje jen vkladani a hledani, uzly se proto nikdy nevypojuji a neni treba resit jejich uvolnovani.
+class skip_list {
+public:
+    static constexpr int MAX_LEVEL = 32;
+
+    class node {
+    public:
+        long long data;
+        int height;
+        std::atomic<node*> next[1];     // Ve skutecnosti 'height' ukazatelu, viz create()
+
+        static node * create(long long data, int height);
+        static void destroy(node * n);
+
+    private:
+        node(long long data, int height) : data(data), height(height) {}
+    };
+
+    skip_list();
+
+    ~skip_list();
+
+    // Vlozi hodnotu, vraci false, pokud uz v seznamu je
+    bool insert(long long data);
+
+    // Je hodnota v seznamu? Pouze cte.
+    bool contains(long long data) const;
+
+    // Projde hodnoty vzestupne. Neni vlaknove bezpecne, slouzi pro kontrolu vysledku.
+    template <typename F>
+    void for_each(F f) const;
+
+private:
+    // Zarazka s nejmensi moznou hodnotou a plnou vyskou
+    node * head;
+
+    // Nejvyssi uroven, na ktere uz nejaky uzel je. Hledani zacina na ni, ne na MAX_LEVEL.
+    std::atomic<int> levels { 1 };
+
+    bool find(long long data, node ** preds, node ** succs) const;
+};
+
+template <typename F>
+void skip_list::for_each(F f) const {
+    for(node * n = head->next[0].load() ; n != nullptr ; n = n->next[0].load()) {
+        f(n->data);
+    }
+}
+
+#endif //PDV_HW03_SKIP_LIST_H
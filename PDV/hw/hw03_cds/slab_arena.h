@@ -0,0 +1,155 @@
+#ifndef PDV_HW03_SLAB_ARENA_H
+#define PDV_HW03_SLAB_ARENA_H
+
+#include <atomic>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+// Alokator objektu jednoho typu po velkych blocich (slabech). Kazde vlakno si bere uzly ze sveho
+// slabu postupne za sebou, takze se globalni halda vola jen jednou za SLAB_BYTES a uzly vytvorene
+// jednim vlaknem tesne po sobe (napr. list a jeho novy rodic ve strome) lezi vedle sebe v pameti.
+// Uvolnene uzly se vraceji do zasobniku 'returned', odkud si je vlakna berou zpet vsechny najednou.
+// Cela arena (vsechny slaby) se uvolni najednou, az ji nikdo nepouziva - tj. po release() vlastnika
+// a po uvolneni vsech uzlu predanych do reclaimer_t.
+//
+// Kazde vlakno si pamatuje rozpracovany slab jen pro jednu arenu. Pri stridani vice aren se zbytek
+// slabu zahodi (pamet se vrati az s arenou).
+template <typename T, typename reclaimer_t>
+class slab_arena {
+    static_assert(std::is_trivially_destructible<T>::value, "Slabs are freed without running destructors");
+
+public:
+    static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+private:
+    // Uzel nese ukazatel na svou arenu, aby ho reclaimer umel vratit i bez znalosti stromu
+    struct slot {
+        slab_arena * owner;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    struct free_slot {
+        free_slot * next;
+    };
+
+    struct slab {
+        slab * next;
+    };
+
+    static constexpr size_t HEADER = (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+    static constexpr size_t PER_SLAB = (SLAB_BYTES - HEADER) / sizeof(slot);
+
+    struct thread_cache {
+        uint64_t arena = 0;
+        slot * bump = nullptr;
+        slot * end = nullptr;
+        free_slot * free = nullptr;
+    };
+
+    const uint64_t id;
+    std::atomic<slab*> slabs { nullptr };
+    std::atomic<free_slot*> returned { nullptr };
+    // Vlastnik + uzly cekajici v reclaimeru
+    std::atomic<long> references { 1 };
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> ids { 1 };
+        return ids.fetch_add(1);
+    }
+
+    static thread_cache & cache() {
+        thread_local thread_cache c;
+        return c;
+    }
+
+    static slot * slot_of(T * object) {
+        return reinterpret_cast<slot*>(reinterpret_cast<char*>(object) - offsetof(slot, storage));
+    }
+
+    void push_returned(slot * s) {
+        free_slot * f = reinterpret_cast<free_slot*>(s);
+        free_slot * head = returned.load();
+        do {
+            f->next = head;
+        } while(!returned.compare_exchange_weak(head, f));
+    }
+
+    slot * allocate() {
+        thread_cache & c = cache();
+        if(c.arena != id) c = thread_cache{id, nullptr, nullptr, nullptr};
+
+        // Nejprve vracene uzly, pak dalsi misto ve slabu, nakonec novy slab
+        if(c.free == nullptr && returned.load(std::memory_order_relaxed) != nullptr) c.free = returned.exchange(nullptr);
+        if(c.free != nullptr) {
+            free_slot * f = c.free;
+            c.free = f->next;
+            return reinterpret_cast<slot*>(f);
+        }
+        if(c.bump == c.end) {
+            char * memory = static_cast<char*>(::operator new(SLAB_BYTES));
+            slab * fresh = reinterpret_cast<slab*>(memory);
+            fresh->next = slabs.load();
+            while(!slabs.compare_exchange_weak(fresh->next, fresh)) {}
+            c.bump = reinterpret_cast<slot*>(memory + HEADER);
+            c.end = c.bump + PER_SLAB;
+        }
+        return c.bump++;
+    }
+
+    static void reclaim(void * pointer) {
+        slot * s = slot_of(static_cast<T*>(pointer));
+        slab_arena * arena = s->owner;
+        arena->push_returned(s);
+        arena->release();
+    }
+
+    ~slab_arena() {
+        slab * s = slabs.load();
+        while(s != nullptr) {
+            slab * next = s->next;
+            ::operator delete(s);
+            s = next;
+        }
+    }
+
+public:
+    slab_arena() : id(next_id()) {}
+
+    slab_arena(const slab_arena &) = delete;
+    slab_arena & operator=(const slab_arena &) = delete;
+
+    template <typename... Args>
+    T * create(Args &&... args) {
+        slot * s = allocate();
+        s->owner = this;
+        return new(&s->storage) T(std::forward<Args>(args)...);
+    }
+
+    // Uzel, ktery nikdy nebyl viditelny ostatnim vlaknum, jde rovnou k dalsimu pouziti
+    void destroy(T * object) {
+        thread_cache & c = cache();
+        free_slot * f = reinterpret_cast<free_slot*>(slot_of(object));
+        if(c.arena == id) {
+            f->next = c.free;
+            c.free = f;
+        } else {
+            push_returned(slot_of(object));
+        }
+    }
+
+    // Vypojeny uzel se vrati do areny, az ho reclaimer uzna za nepouzivany
+    void retire(T * object) {
+        references.fetch_add(1, std::memory_order_relaxed);
+        reclaimer_t::instance().retire(object, &slab_arena::reclaim, sizeof(slot));
+    }
+
+    // Vlastnik arenu uz nepotrebuje. Slaby se uvolni hned, nebo az se vrati posledni vypojeny uzel.
+    void release() {
+        if(references.fetch_sub(1) == 1) delete this;
+    }
+};
+
+#endif //PDV_HW03_SLAB_ARENA_H
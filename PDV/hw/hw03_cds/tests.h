@@ -6,17 +6,20 @@
 #include <algorithm>
 #include <functional>
 #include <cstdlib>
+#include <random>
 
 #include "bst_tree.h"
+#include "skip_list.h"
 
 // Oba nase testy se skladaji ze vkladani sekvence cisel 0..N-1 do Vaseho binarniho vyhledavaciho
 // stromu (at uz v serazenem nebo neserazenem poradi). Oba tyto testy jsou v zakladu velice podob-
-// ne, a implementujeme proto na zaklade stejne tridy 'base_test'.
-template <unsigned int N>
+// ne, a implementujeme proto na zaklade stejne tridy 'base_test'. Misto stromu lze testovat i jinou
+// mnozinu se stejnym rozhranim (insert, for_each), napr. skip_list.
+template <unsigned int N, typename set_t = bst_tree>
 class base_test {
 public:
     std::vector<long long> data;   // Data, ktera budeme do stromu vkladat
-    bst_tree tree;                 // Instance stromu
+    set_t tree;                    // Instance stromu
 
     base_test() : data(N) {
         // Vytvorime si sekvenci cisel 0..N-1
@@ -39,16 +42,10 @@ public:
     // Kontrola spravnosti vysledku
     bool verify() {
         // Strom prochazime v poradi inorder a jeho prvky si vkladame do pole. Diky vlastnostem binarniho
-        // vyhledavaciho stromu by vysledkem melo byt serazene pole.
+        // vyhledavaciho stromu by vysledkem melo byt serazene pole. (Strom je externi, for_each proto
+        // vraci jen hodnoty v listech.)
         std::vector<long long> content;
-        std::function<void(bst_tree::node*)> inorder = [&](bst_tree::node * node) {
-            if(node != nullptr) {
-                inorder(node->left);
-                content.push_back(node->data);
-                inorder(node->right);
-            }
-        };
-        inorder(tree.root);
+        tree.for_each([&](long long value) { content.push_back(value); });
 
         // Nyni zkontrolujeme, ze pole 'content' skutecne obsahuje serazena cisla 0..N-1
         if(content.size() != N) return false;
@@ -61,8 +58,8 @@ public:
 
 // Test 'shuffled_data' se od zakladniho testu lisi pouze tim, ze vstupni data, ktera se vkladaji do
 // binarniho vyhledavaciho stromu jsou zprehazena.
-template <unsigned int N>
-class shuffled_data : public base_test<N> {
+template <unsigned int N, typename set_t = bst_tree>
+class shuffled_data : public base_test<N, set_t> {
 public:
     shuffled_data() {
         srand(0L);
@@ -71,8 +68,131 @@ public:
 };
 
 // Test se serazenymi daty je identicky jako zakladni test.
+template <unsigned int N, typename set_t = bst_tree>
+class sorted_data : public base_test<N, set_t> {
+};
+
+// Cely serazeny vektor 'data' se vlozi jednim volanim bulk_load. Vysledny strom je dokonale vyvazeny.
 template <unsigned int N>
-class sorted_data : public base_test<N> {
+class bulk_loaded : public base_test<N> {
+public:
+    void run_test() {
+        this->tree.bulk_load(this->data.data(), this->data.data() + N);
+    }
+};
+
+// Zamichana data se vkladaji po davkach velikosti BATCH pres insert_batch. Davky jdou za sebou,
+// paralelne se zpracovava obsah kazde davky.
+template <unsigned int N, unsigned int BATCH = N / 16>
+class batched_insert : public shuffled_data<N> {
+public:
+    void run_test() {
+        for(unsigned int begin = 0 ; begin < N ; begin += BATCH) {
+            const unsigned int end = std::min(N, begin + BATCH);
+            this->tree.insert_batch(this->data.data() + begin, this->data.data() + end);
+        }
+    }
+};
+
+// Strom s uzly alokovanymi po jednom pres new/delete, pro srovnani se slab_arena
+class bst_tree_heap : public bst_tree {
+public:
+    bst_tree_heap() : bst_tree(bst_tree::HEAP) {}
+};
+
+// Smiseny test: N operaci nad klici 0..K-1, z toho READ_PERCENT procent hledani a zbytek napul
+// vkladani a mazani. Strom je predem naplnen sudymi klici. Operace i a jeji klic jsou dany jen
+// indexem i, takze je zatez stejna pro libovolny pocet vlaken.
+template <unsigned int N, unsigned int K = N / 10, unsigned int READ_PERCENT = 80>
+class mixed_operations {
+public:
+    bst_tree tree;
+    long long inserted = 0;     // Pocet uspesnych vlozeni (vcetne predplneni)
+    long long removed = 0;      // Pocet uspesnych odebrani
+
+    mixed_operations() {
+        // Sude klice vkladame zamichane, serazene by strom zdegenerovaly na seznam
+        std::vector<long long> keys;
+        for(unsigned int k = 0 ; k < K ; k += 2) keys.push_back(k);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+        for(long long k : keys) {
+            if(tree.insert(k)) inserted++;
+        }
+    }
+
+    // SplitMix64, nahodne cislo pro operaci i
+    static unsigned long long hash(unsigned long long i) {
+        unsigned long long z = (i + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    void run_test() {
+        long long ins = 0, rem = 0, found = 0;
+        #pragma omp parallel for schedule(static, 1024) reduction(+:ins, rem, found)
+        for(int i = 0 ; i < static_cast<int>(N); i++) {
+            const unsigned long long r = hash(i);
+            const long long key = static_cast<long long>((r >> 8) % K);
+            const unsigned int kind = static_cast<unsigned int>(r % 100);
+            if(kind < READ_PERCENT) {
+                if(tree.contains(key)) found++;
+            } else if((kind - READ_PERCENT) % 2 == 0) {
+                if(tree.insert(key)) ins++;
+            } else {
+                if(tree.remove(key)) rem++;
+            }
+        }
+        inserted += ins;
+        removed += rem;
+        // Aby prekladac hledani nevyhodil
+        if(found < 0) throw "unreachable";
+    }
+
+    // Strom musi byt serazeny, bez duplicit, v rozsahu klicu a jeho velikost musi odpovidat
+    // uspesnym operacim. Kazdy prvek musi byt nalezitelny pres contains.
+    bool verify() {
+        std::vector<long long> content;
+        tree.for_each([&](long long value) { content.push_back(value); });
+        for(size_t i = 0 ; i < content.size() ; i++) {
+            if(content[i] < 0 || content[i] >= K) return false;
+            if(i > 0 && content[i - 1] >= content[i]) return false;
+            if(!tree.contains(content[i])) return false;
+        }
+        return static_cast<long long>(content.size()) == inserted - removed;
+    }
+};
+
+// Zatezovy test uvolnovani pameti: N dvojic vlozeni a odebrani nad malym rozsahem klicu, takze
+// se neustale vypojuji uzly. Strom musi byt na konci prazdny a nejvetsi mnozstvi vypojenych, ale
+// neuvolnenych uzlu (viz reclamation.h) nesmi rust s N.
+template <unsigned int N, unsigned int K = 4096>
+class reclamation_churn {
+public:
+    bst_tree tree;
+
+    reclamation_churn() {
+        bst_tree::reclaimer::instance().memory().reset_peak();
+    }
+
+    void run_test() {
+        #pragma omp parallel for schedule(static, 256)
+        for(int i = 0 ; i < static_cast<int>(N); i++) {
+            const long long key = (static_cast<long long>(i) * 2654435761LL) % K;
+            tree.insert(key);
+            tree.remove(key);
+        }
+    }
+
+    bool verify() {
+        bool empty = true;
+        tree.for_each([&](long long) { empty = false; });
+        return empty;
+    }
+
+    static long long peak_retired_bytes() {
+        return bst_tree::reclaimer::instance().memory().peak_bytes();
+    }
 };
 
 #endif //PDV_HW03_TESTS_H
@@ -0,0 +1,117 @@
+#ifndef DATABASEQUERIES_ASYNC_PREDICATE_H
+#define DATABASEQUERIES_ASYNC_PREDICATE_H
+
+#include <vector>
+#include <queue>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+// Asynchronni predikaty pro data, jejichz cteni trva dlouho (disk, sit). Predikat vyhodnoceni jen
+// zahaji (submit) a vysledek se pozdeji objevi ve fronte dokoncenych pozadavku vlakna, podobne jako
+// u io_uring. Vlakno tak muze mit rozpracovanych mnoho kontrol naraz a ceka na vsechny soucasne
+// misto na kazdou zvlast.
+
+// Uspani vlakna (sleep_until) se na Linuxu protahne o desitky mikrosekund (timer slack, planovac).
+// Cekani kratsi nez tato rezerva by merilo ji misto latence pozadavku, proto se prockava aktivne.
+const std::chrono::microseconds sleep_slack(100);
+
+// Fronta dokoncenych pozadavku jednoho vlakna (neni vlaknove bezpecna). Pozadavek se pozna podle
+// znacky 'tag', kterou zvolil ten, kdo ho zadal.
+class completion_queue_t {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    struct completion_t {
+        uint32_t tag;
+        bool result;
+    };
+
+    // Pozadavek 'tag' bude dokoncen v case 'ready' s vysledkem 'result'
+    void push(clock::time_point ready, uint32_t tag, bool result) {
+        pending.push(entry_t{ready, completion_t{tag, result}});
+    }
+
+    size_t size() const { return pending.size(); }
+    bool empty() const { return pending.empty(); }
+
+    // Pocka na dokonceni nejblizsiho pozadavku a prida do 'completed' vsechny dokoncene. Vic nez
+    // sleep_slack pred dokoncenim vlakno spi, zbytek (i cela kratka cekani) hlida hodiny aktivne.
+    // Na prazdne fronte se vrati hned.
+    void wait(std::vector<completion_t> &completed) {
+        if (pending.empty()) return;
+        const clock::time_point ready = pending.top().ready;
+        clock::time_point now = clock::now();
+        if (ready - now > sleep_slack) {
+            std::this_thread::sleep_until(ready - sleep_slack);
+            now = clock::now();
+        }
+        while (now < ready) now = clock::now();
+        while (!pending.empty() && pending.top().ready <= now) {
+            completed.push_back(pending.top().completion);
+            pending.pop();
+        }
+    }
+
+private:
+    struct entry_t {
+        clock::time_point ready;
+        completion_t completion;
+
+        bool operator>(const entry_t &other) const { return ready > other.ready; }
+    };
+
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> pending;
+};
+
+// Predikat, jehoz vyhodnoceni pro jeden radek se zadava do fronty vlakna
+template<typename row_t>
+class async_predicate_t {
+public:
+    class kernel_t {
+    public:
+        virtual ~kernel_t() {}
+
+        // Viz async_predicate_t::submit
+        virtual void submit(const row_t &row, uint32_t tag, completion_queue_t &queue) const = 0;
+    };
+
+    async_predicate_t() {}
+
+    explicit async_predicate_t(std::shared_ptr<const kernel_t> kernel) : kernel(std::move(kernel)) {}
+
+    // Zahaji vyhodnoceni predikatu pro radek 'row', vysledek prijde do 'queue' pod znackou 'tag'
+    void submit(const row_t &row, uint32_t tag, completion_queue_t &queue) const {
+        kernel->submit(row, tag, queue);
+    }
+
+private:
+    std::shared_ptr<const kernel_t> kernel;
+};
+
+// Simulace pomaleho cteni: vysledek funkce je znamy hned, do fronty ale dorazi az po 'latency'.
+// Na rozdil od predicate_checking_simulation_function (generator.cpp) se na vysledek neceka pri zadani,
+// takze se cekani na vice rozpracovanych cteni prekryva.
+template<typename row_t>
+class delayed_kernel : public async_predicate_t<row_t>::kernel_t {
+public:
+    delayed_kernel(std::function<bool(const row_t &)> function, std::chrono::nanoseconds latency)
+            : function(std::move(function)), latency(latency) {}
+
+    void submit(const row_t &row, uint32_t tag, completion_queue_t &queue) const override {
+        queue.push(completion_queue_t::clock::now() + latency, tag, function(row));
+    }
+
+private:
+    std::function<bool(const row_t &)> function;
+    std::chrono::nanoseconds latency;
+};
+
+template<typename row_t>
+async_predicate_t<row_t> delayed(std::function<bool(const row_t &)> predicate, std::chrono::nanoseconds latency) {
+    return async_predicate_t<row_t>(std::make_shared<delayed_kernel<row_t>>(std::move(predicate), latency));
+}
+
+#endif //DATABASEQUERIES_ASYNC_PREDICATE_H
@@ -0,0 +1,246 @@
+#ifndef DATABASEQUERIES_COLUMNAR_EXPRESSION_H
+#define DATABASEQUERIES_COLUMNAR_EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+// Vyrazy pro predikaty nad sloupcem celych cisel (radek test_row_t je jedno cislo). Misto funkce,
+// ktera se vola pro kazdy radek zvlast, se z vyrazu pri prekladu sestavi jedna smycka, ktera
+// vyhodnoti cely blok BLOCK_ROWS radku naraz: kazdy uzel vyrazu zapise pro kazdy radek bloku masku
+// (0 nebo -1) a spojky masky jen spojuji bitovym and/or. Smycky nemaji zadne vetveni, takze je
+// prekladac vektorizuje (s AVX2 8 radku na instrukci, viz predicate.h).
+//
+// Priklad:
+//     using namespace columnar;
+//     auto p = (value >= 10 && value <= 20 && value % 3 == 0) || value == -1;
+//     compiled_predicate_t<int> c = compile<int>(p);
+namespace columnar {
+
+typedef int value_t;                // Typ hodnot ve sloupci
+typedef int32_t lane_t;             // Maska jednoho radku: 0 (neplati) nebo -1 (plati)
+
+constexpr size_t BLOCK_ROWS = 64;   // Radku na jedno vyhodnoceni = bitu v jednom slove bitmapy
+
+// Uzavreny interval hodnot [low, high], pro low > high prazdny
+struct interval_t {
+    value_t low, high;
+
+    static interval_t all() {
+        return interval_t{std::numeric_limits<value_t>::min(), std::numeric_limits<value_t>::max()};
+    }
+
+    static interval_t none() {
+        return interval_t{std::numeric_limits<value_t>::max(), std::numeric_limits<value_t>::min()};
+    }
+
+    bool empty() const { return low > high; }
+
+    bool overlaps(value_t min, value_t max) const { return !empty() && low <= max && min <= high; }
+};
+
+inline interval_t intersect(interval_t a, interval_t b) {
+    return interval_t{std::max(a.low, b.low), std::min(a.high, b.high)};
+}
+
+inline interval_t hull(interval_t a, interval_t b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return interval_t{std::min(a.low, b.low), std::max(a.high, b.high)};
+}
+
+// Nejmensi intervaly obsahujici vsechny hodnoty, ktere splnuji value <op> constant
+inline interval_t bounds_of(std::equal_to<value_t>, value_t constant) {
+    return interval_t{constant, constant};
+}
+
+inline interval_t bounds_of(std::not_equal_to<value_t>, value_t) {
+    return interval_t::all();
+}
+
+inline interval_t bounds_of(std::less<value_t>, value_t constant) {
+    if (constant == std::numeric_limits<value_t>::min()) return interval_t::none();
+    return interval_t{std::numeric_limits<value_t>::min(), constant - 1};
+}
+
+inline interval_t bounds_of(std::less_equal<value_t>, value_t constant) {
+    return interval_t{std::numeric_limits<value_t>::min(), constant};
+}
+
+inline interval_t bounds_of(std::greater<value_t>, value_t constant) {
+    if (constant == std::numeric_limits<value_t>::max()) return interval_t::none();
+    return interval_t{constant + 1, std::numeric_limits<value_t>::max()};
+}
+
+inline interval_t bounds_of(std::greater_equal<value_t>, value_t constant) {
+    return interval_t{constant, std::numeric_limits<value_t>::max()};
+}
+
+// Spolecny predek vsech uzlu, jen aby se operatory && || ! nepouzily na cokoliv jineho.
+// Kazdy uzel ma metodu evaluate(rows, lanes), ktera vyplni BLOCK_ROWS masek, a metodu bounds(),
+// ktera vrati interval obsahujici vsechny splnujici hodnoty (muze byt i vetsi). Podle nej se
+// hleda v indexu a preskakuji bloky tabulky (viz _table/index.h).
+template<typename derived_t>
+struct expression {
+    const derived_t &self() const { return static_cast<const derived_t &>(*this); }
+};
+
+// value <op> constant
+template<typename compare_t>
+struct comparison : expression<comparison<compare_t>> {
+    value_t constant;
+
+    explicit comparison(value_t constant) : constant(constant) {}
+
+    interval_t bounds() const { return bounds_of(compare_t(), constant); }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        compare_t compare;
+        for (size_t j = 0; j < BLOCK_ROWS; j++) lanes[j] = -static_cast<lane_t>(compare(rows[j], constant));
+    }
+};
+
+// low <= value <= high
+struct range : expression<range> {
+    value_t low, high;
+
+    range(value_t low, value_t high) : low(low), high(high) {}
+
+    interval_t bounds() const { return interval_t{low, high}; }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        for (size_t j = 0; j < BLOCK_ROWS; j++) lanes[j] = -static_cast<lane_t>((rows[j] >= low) & (rows[j] <= high));
+    }
+};
+
+// value % divisor == rest. Celociselne deleni SIMD instrukce nemaji, podil se proto pocita v double:
+// pro 32bitova cisla je presny, takze zbytek vyjde stejne jako u operatoru %.
+struct remainder : expression<remainder> {
+    value_t divisor, rest;
+
+    remainder(value_t divisor, value_t rest) : divisor(divisor), rest(rest) {}
+
+    interval_t bounds() const { return interval_t::all(); }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        const double d = divisor;
+        for (size_t j = 0; j < BLOCK_ROWS; j++) {
+            const value_t quotient = static_cast<value_t>(static_cast<double>(rows[j]) / d);
+            lanes[j] = -static_cast<lane_t>(rows[j] - quotient * divisor == rest);
+        }
+    }
+};
+
+template<typename left_t, typename right_t>
+struct conjunction : expression<conjunction<left_t, right_t>> {
+    left_t left;
+    right_t right;
+
+    conjunction(const left_t &left, const right_t &right) : left(left), right(right) {}
+
+    interval_t bounds() const { return intersect(left.bounds(), right.bounds()); }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        lane_t other[BLOCK_ROWS];
+        left.evaluate(rows, lanes);
+        right.evaluate(rows, other);
+        for (size_t j = 0; j < BLOCK_ROWS; j++) lanes[j] &= other[j];
+    }
+};
+
+template<typename left_t, typename right_t>
+struct disjunction : expression<disjunction<left_t, right_t>> {
+    left_t left;
+    right_t right;
+
+    disjunction(const left_t &left, const right_t &right) : left(left), right(right) {}
+
+    interval_t bounds() const { return hull(left.bounds(), right.bounds()); }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        lane_t other[BLOCK_ROWS];
+        left.evaluate(rows, lanes);
+        right.evaluate(rows, other);
+        for (size_t j = 0; j < BLOCK_ROWS; j++) lanes[j] |= other[j];
+    }
+};
+
+template<typename operand_t>
+struct negation : expression<negation<operand_t>> {
+    operand_t operand;
+
+    explicit negation(const operand_t &operand) : operand(operand) {}
+
+    interval_t bounds() const { return interval_t::all(); }
+
+    void evaluate(const value_t *rows, lane_t *lanes) const {
+        operand.evaluate(rows, lanes);
+        for (size_t j = 0; j < BLOCK_ROWS; j++) lanes[j] = ~lanes[j];
+    }
+};
+
+// Zastupce hodnoty radku ve vyrazech, napr. value < 5
+struct column {};
+constexpr column value{};
+
+// Mezivysledek value % divisor, sam o sobe neni predikat
+struct modulo {
+    value_t divisor;
+};
+
+inline comparison<std::equal_to<value_t>> operator==(column, value_t constant) {
+    return comparison<std::equal_to<value_t>>(constant);
+}
+
+inline comparison<std::not_equal_to<value_t>> operator!=(column, value_t constant) {
+    return comparison<std::not_equal_to<value_t>>(constant);
+}
+
+inline comparison<std::less<value_t>> operator<(column, value_t constant) {
+    return comparison<std::less<value_t>>(constant);
+}
+
+inline comparison<std::less_equal<value_t>> operator<=(column, value_t constant) {
+    return comparison<std::less_equal<value_t>>(constant);
+}
+
+inline comparison<std::greater<value_t>> operator>(column, value_t constant) {
+    return comparison<std::greater<value_t>>(constant);
+}
+
+inline comparison<std::greater_equal<value_t>> operator>=(column, value_t constant) {
+    return comparison<std::greater_equal<value_t>>(constant);
+}
+
+inline modulo operator%(column, value_t divisor) {
+    return modulo{divisor};
+}
+
+inline remainder operator==(modulo m, value_t rest) {
+    return remainder(m.divisor, rest);
+}
+
+inline range between(value_t low, value_t high) {
+    return range(low, high);
+}
+
+template<typename left_t, typename right_t>
+conjunction<left_t, right_t> operator&&(const expression<left_t> &left, const expression<right_t> &right) {
+    return conjunction<left_t, right_t>(left.self(), right.self());
+}
+
+template<typename left_t, typename right_t>
+disjunction<left_t, right_t> operator||(const expression<left_t> &left, const expression<right_t> &right) {
+    return disjunction<left_t, right_t>(left.self(), right.self());
+}
+
+template<typename operand_t>
+negation<operand_t> operator!(const expression<operand_t> &operand) {
+    return negation<operand_t>(operand.self());
+}
+
+}
+
+#endif //DATABASEQUERIES_COLUMNAR_EXPRESSION_H
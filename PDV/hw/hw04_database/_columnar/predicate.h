@@ -0,0 +1,178 @@
+#ifndef DATABASEQUERIES_COLUMNAR_PREDICATE_H
+#define DATABASEQUERIES_COLUMNAR_PREDICATE_H
+
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+
+#include "expression.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define COLUMNAR_SIMD_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace columnar {
+
+// Predikat pripraveny k vyhodnoceni po blocich. Virtualni volani je jedno na cely usek tabulky,
+// ne na kazdy radek, takze vnitrek (zkompilovany vyraz) muze byt inlinovany a vektorizovany.
+// Vznika funkci compile - bud z vyrazu (expression.h), nebo z libovolne std::function jako zalozni
+// varianta, ktera funkci vola radek po radku.
+template<typename row_t>
+class compiled_predicate_t {
+public:
+    class kernel_t {
+    public:
+        virtual ~kernel_t() {}
+
+        // Viz compiled_predicate_t::select
+        virtual void select(const row_t *rows, size_t count, uint64_t *bitmap) const = 0;
+
+        // Viz compiled_predicate_t::bounds
+        virtual bool bounds(interval_t &) const { return false; }
+    };
+
+    compiled_predicate_t() {}
+
+    explicit compiled_predicate_t(std::shared_ptr<const kernel_t> kernel) : kernel(std::move(kernel)) {}
+
+    // Vyhodnoti radky rows[0..count) a zapise bitmapu vybranych radku: bit j slova w odpovida
+    // radku 64 * w + j. Bitmapa musi mit alespon (count + 63) / 64 slov, bity za 'count' jsou nulove.
+    void select(const row_t *rows, size_t count, uint64_t *bitmap) const {
+        kernel->select(rows, count, bitmap);
+    }
+
+    // Interval, mimo ktery zadna hodnota predikat nesplnuje. Vraci false pro nepruhledne predikaty
+    // (std::function), o kterych nic nevime.
+    bool bounds(interval_t &interval) const {
+        return kernel->bounds(interval);
+    }
+
+private:
+    std::shared_ptr<const kernel_t> kernel;
+};
+
+// Prevod masek jednoho bloku na slovo bitmapy
+inline uint64_t pack_lanes(const lane_t *lanes) {
+    uint64_t word = 0;
+#ifdef COLUMNAR_SIMD_DISPATCH
+    for (size_t j = 0; j < BLOCK_ROWS; j += 4) {
+        const __m128 mask = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes + j)));
+        word |= static_cast<uint64_t>(_mm_movemask_ps(mask)) << j;
+    }
+#else
+    for (size_t j = 0; j < BLOCK_ROWS; j++) word |= static_cast<uint64_t>(lanes[j] & 1) << j;
+#endif
+    return word;
+}
+
+template<typename expression_t>
+void select_blocks_default(const expression_t &expression, const value_t *rows, size_t blocks, uint64_t *bitmap) {
+    lane_t lanes[BLOCK_ROWS];
+    for (size_t b = 0; b < blocks; b++) {
+        expression.evaluate(rows + b * BLOCK_ROWS, lanes);
+        bitmap[b] = pack_lanes(lanes);
+    }
+}
+
+#ifdef COLUMNAR_SIMD_DISPATCH
+
+// Stejna smycka prelozena pro AVX2. Vyraz se do ni cely inlinuje, takze se i jeho smycky
+// vektorizuji 256bitovymi instrukcemi (8 radku najednou).
+template<typename expression_t>
+__attribute__((target("avx2")))
+void select_blocks_avx2(const expression_t &expression, const value_t *rows, size_t blocks, uint64_t *bitmap) {
+    lane_t lanes[BLOCK_ROWS];
+    for (size_t b = 0; b < blocks; b++) {
+        expression.evaluate(rows + b * BLOCK_ROWS, lanes);
+        uint64_t word = 0;
+        for (size_t j = 0; j < BLOCK_ROWS; j += 8) {
+            const __m256 mask = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes + j)));
+            word |= static_cast<uint64_t>(_mm256_movemask_ps(mask)) << j;
+        }
+        bitmap[b] = word;
+    }
+}
+
+inline bool has_avx2() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+
+#endif
+
+template<typename expression_t>
+void select_blocks(const expression_t &expression, const value_t *rows, size_t blocks, uint64_t *bitmap) {
+#ifdef COLUMNAR_SIMD_DISPATCH
+    if (has_avx2()) {
+        select_blocks_avx2(expression, rows, blocks, bitmap);
+        return;
+    }
+#endif
+    select_blocks_default(expression, rows, blocks, bitmap);
+}
+
+template<typename row_t, typename expression_t>
+class expression_kernel : public compiled_predicate_t<row_t>::kernel_t {
+    static_assert(std::is_same<row_t, value_t>::value, "Expressions are evaluated over a column of value_t");
+
+public:
+    explicit expression_kernel(const expression_t &expression) : expression(expression) {}
+
+    void select(const row_t *rows, size_t count, uint64_t *bitmap) const override {
+        const size_t blocks = count / BLOCK_ROWS;
+        select_blocks(expression, rows, blocks, bitmap);
+
+        // Posledni neuplny blok se doplni nulami a prebytecne bity se smazou
+        const size_t tail = count % BLOCK_ROWS;
+        if (tail != 0) {
+            value_t padded[BLOCK_ROWS] = {};
+            std::copy(rows + blocks * BLOCK_ROWS, rows + count, padded);
+            select_blocks_default(expression, padded, 1, bitmap + blocks);
+            bitmap[blocks] &= (static_cast<uint64_t>(1) << tail) - 1;
+        }
+    }
+
+    bool bounds(interval_t &interval) const override {
+        interval = expression.bounds();
+        return true;
+    }
+
+private:
+    expression_t expression;
+};
+
+template<typename row_t>
+class function_kernel : public compiled_predicate_t<row_t>::kernel_t {
+public:
+    explicit function_kernel(std::function<bool(const row_t &)> function) : function(std::move(function)) {}
+
+    void select(const row_t *rows, size_t count, uint64_t *bitmap) const override {
+        for (size_t w = 0; w < (count + 63) / 64; w++) bitmap[w] = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (function(rows[i])) bitmap[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+        }
+    }
+
+private:
+    std::function<bool(const row_t &)> function;
+};
+
+template<typename row_t, typename expression_t>
+compiled_predicate_t<row_t> compile(const expression<expression_t> &predicate) {
+    return compiled_predicate_t<row_t>(std::make_shared<expression_kernel<row_t, expression_t>>(predicate.self()));
+}
+
+// Zalozni varianta pro predikaty, ktere jako vyraz zapsat nejdou
+template<typename row_t>
+compiled_predicate_t<row_t> compile(std::function<bool(const row_t &)> predicate) {
+    return compiled_predicate_t<row_t>(std::make_shared<function_kernel<row_t>>(std::move(predicate)));
+}
+
+}
+
+#endif //DATABASEQUERIES_COLUMNAR_PREDICATE_H
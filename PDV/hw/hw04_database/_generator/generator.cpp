@@ -11,6 +11,9 @@
 // generator nahodnych cisel (Mersenne-Twister)
 std::mt19937 rng(SEED);
 
+// Jak dlouho trva simulovane cteni dat pro kontrolu predikatu
+const std::chrono::microseconds predicate_checking_latency(2);
+
 // Funkce simulujici kontrolu predikatu
 // V realnych podminkach neni kontrola platnosti predikatu okamzita, napriklad je potreba provest operaci
 // s daty ulozenymi na disku.
@@ -20,7 +23,7 @@ void predicate_checking_simulation_function() {
     auto begin = steady_clock::now();
     while(true) {
         auto now = steady_clock::now();
-        if(duration_cast<microseconds>(now-begin).count() >= 2L) break; // Pockame alespon 1us na data
+        if(duration_cast<microseconds>(now-begin) >= predicate_checking_latency) break; // Pockame alespon 1us na data
     }
 }
 
@@ -64,7 +67,8 @@ fill_vector_by_bools_by_ppt(const double ppt_of_true, std::vector<bool> &to_fill
 // zbyle parametry odpovidaji parametrum metody generate_instance_with_query v hlavickovem souboru
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
 generate_instance_with_query(const int length_of_query, const int count_of_rows, const bool bool_value_to_ensure,
-                             const double t_probability_predicate) {
+                             const double t_probability_predicate, compiled_predicates_t *compiled,
+                             async_predicates_t *async) {
     if (length_of_query > count_of_rows) {
         throw std::invalid_argument("there should be more rows than queries");
     }
@@ -99,6 +103,11 @@ generate_instance_with_query(const int length_of_query, const int count_of_rows,
             // pouze pokud je hodnota rovna ocekavane hodnote, je predikat splnen
             return value == value_t;
         };
+        if (compiled) compiled->push_back(columnar::compile<test_row_t>(columnar::value == value_t));
+        if (async) {
+            async->push_back(delayed<test_row_t>([value_t](const test_row_t &value) { return value == value_t; },
+                                                 predicate_checking_latency));
+        }
     }
     return std::make_pair(data, predicates);
 }
@@ -106,7 +115,8 @@ generate_instance_with_query(const int length_of_query, const int count_of_rows,
 // generuje data pro konjunkci, kdy evaluace dotazu je true
 // zbyle parametry odpovidaji parametrum metody generate_instance_with_query v hlavickovem souboru
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
-generate_instance_with_query_conjunction_t(const int length_of_query, const int count_of_rows) {
+generate_instance_with_query_conjunction_t(const int length_of_query, const int count_of_rows,
+                                           compiled_predicates_t *compiled, async_predicates_t *async) {
 
     if (length_of_query > count_of_rows) {
         throw std::invalid_argument("there should be more rows than queries");
@@ -136,6 +146,15 @@ generate_instance_with_query_conjunction_t(const int length_of_query, const int
             // pokud hodnota odpovida pozadovane hodnote, vratime true. vetsina hodnot by mela byt true
             return value >= start_index_number && value <= end_index_number && (value % space == 0);
         };
+        if (compiled) {
+            using namespace columnar;
+            compiled->push_back(compile<test_row_t>(between(start_index_number, end_index_number) && value % space == 0));
+        }
+        if (async) {
+            async->push_back(delayed<test_row_t>([start_index_number, end_index_number, space](const test_row_t &value) {
+                return value >= start_index_number && value <= end_index_number && (value % space == 0);
+            }, predicate_checking_latency));
+        }
     }
     return std::make_pair(data, predicates);
 }
@@ -143,7 +162,8 @@ generate_instance_with_query_conjunction_t(const int length_of_query, const int
 // generuje data pro dotaz s disjunkcemi - evaluace je false
 // zbyle parametry odpovidaji parametrum metody generate_instance_with_query v hlavickovem souboru
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
-generate_instance_with_query_disjunction_f(const int length_of_query, const int count_of_rows) {
+generate_instance_with_query_disjunction_f(const int length_of_query, const int count_of_rows,
+                                           compiled_predicates_t *compiled, async_predicates_t *async) {
 
     // vytvorime data v tabulce. v tabulce jsou hodnoty od 0 az (count_of_rows - 1). tyto hodnoty nejsou setridene
     std::vector<int> data(count_of_rows);
@@ -161,6 +181,11 @@ generate_instance_with_query_disjunction_f(const int length_of_query, const int
             // zadny predikat neni platny. -1 se v tabulce nevyskytuje
             return value == -1;
         };
+        if (compiled) compiled->push_back(columnar::compile<test_row_t>(columnar::value == -1));
+        if (async) {
+            async->push_back(delayed<test_row_t>([](const test_row_t &value) { return value == -1; },
+                                                 predicate_checking_latency));
+        }
     }
     return std::make_pair(data, predicates);
 }
@@ -168,26 +193,37 @@ generate_instance_with_query_disjunction_f(const int length_of_query, const int
 // implementace metody. komentar viz hlavickovy soubor
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
 generate_instance_with_query(Operation operation, bool is_query_evaluated_true, const int length_of_query,
-                             const int count_of_rows) {
+                             const int count_of_rows, compiled_predicates_t *compiled, async_predicates_t *async) {
+    const double t_probability_predicate = operation == conjunction ? t_probability_conjunction_predicate
+                                                                    : t_probability_disjunction_predicate;
+    return generate_instance_with_query(operation, is_query_evaluated_true, length_of_query, count_of_rows,
+                                        t_probability_predicate, SEED, compiled, async);
+}
 
-    // reset naseho generatoru nahodnych cisel. pouzivame konstantu - kvuli replikovatelnosti vysledku
-    rng.seed(SEED);
+// implementace metody. komentar viz hlavickovy soubor
+std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
+generate_instance_with_query(Operation operation, bool is_query_evaluated_true, const int length_of_query,
+                             const int count_of_rows, const double t_probability_predicate, const unsigned int seed,
+                             compiled_predicates_t *compiled, async_predicates_t *async) {
+
+    // reset naseho generatoru nahodnych cisel. pouzivame zadany seed - kvuli replikovatelnosti vysledku
+    rng.seed(seed);
 
     // na zaklade operace a ocekavane evaluace dotazu vybereme vhodnou metodu na generovani dat - implementace viz vyse
     switch (operation) {
         case conjunction:
             if (is_query_evaluated_true) {
-                return generate_instance_with_query_conjunction_t(length_of_query, count_of_rows);
+                return generate_instance_with_query_conjunction_t(length_of_query, count_of_rows, compiled, async);
             } else {
                 return generate_instance_with_query(length_of_query, count_of_rows, false,
-                                                    t_probability_conjunction_predicate);
+                                                    t_probability_predicate, compiled, async);
             }
         case disjunction:
             if (is_query_evaluated_true) {
                 return generate_instance_with_query(length_of_query, count_of_rows, true,
-                                                    t_probability_disjunction_predicate);
+                                                    t_probability_predicate, compiled, async);
             } else {
-                return generate_instance_with_query_disjunction_f(length_of_query, count_of_rows);
+                return generate_instance_with_query_disjunction_f(length_of_query, count_of_rows, compiled, async);
             }
     }
     throw std::invalid_argument("not supported operation");
@@ -211,4 +247,40 @@ std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>> generat
     else{
         return generate_instance_with_query(disjunction, expected, length_of_query_any_false, count_of_rows_any_false);
     }
+}
+
+// implementace metody. komentar viz hlavickovy soubor
+std::pair<std::vector<test_row_t>, compiled_predicates_t> generate_all_compiled(bool expected) {
+    compiled_predicates_t compiled;
+    auto instance = expected
+            ? generate_instance_with_query(conjunction, expected, length_of_query_all_true, count_of_rows_all_true, &compiled)
+            : generate_instance_with_query(conjunction, expected, length_of_query_all_false, count_of_rows_all_false, &compiled);
+    return std::make_pair(std::move(instance.first), std::move(compiled));
+}
+
+// implementace metody. komentar viz hlavickovy soubor
+std::pair<std::vector<test_row_t>, compiled_predicates_t> generate_any_compiled(bool expected) {
+    compiled_predicates_t compiled;
+    auto instance = expected
+            ? generate_instance_with_query(disjunction, expected, length_of_query_any_true, count_of_rows_any_true, &compiled)
+            : generate_instance_with_query(disjunction, expected, length_of_query_any_false, count_of_rows_any_false, &compiled);
+    return std::make_pair(std::move(instance.first), std::move(compiled));
+}
+
+// implementace metody. komentar viz hlavickovy soubor
+std::pair<std::vector<test_row_t>, async_predicates_t> generate_all_async(bool expected) {
+    async_predicates_t async;
+    auto instance = expected
+            ? generate_instance_with_query(conjunction, expected, length_of_query_all_true, count_of_rows_all_true, nullptr, &async)
+            : generate_instance_with_query(conjunction, expected, length_of_query_all_false, count_of_rows_all_false, nullptr, &async);
+    return std::make_pair(std::move(instance.first), std::move(async));
+}
+
+// implementace metody. komentar viz hlavickovy soubor
+std::pair<std::vector<test_row_t>, async_predicates_t> generate_any_async(bool expected) {
+    async_predicates_t async;
+    auto instance = expected
+            ? generate_instance_with_query(disjunction, expected, length_of_query_any_true, count_of_rows_any_true, nullptr, &async)
+            : generate_instance_with_query(disjunction, expected, length_of_query_any_false, count_of_rows_any_false, nullptr, &async);
+    return std::make_pair(std::move(instance.first), std::move(async));
 }
\ No newline at end of file
@@ -14,6 +14,12 @@
 // datovy typ radku v nasi simulovane databazi
 using test_row_t = int;
 
+// stejne predikaty zapsane jako columnar vyrazy (viz _columnar/expression.h)
+using compiled_predicates_t = std::vector<compiled_predicate_t<test_row_t>>;
+
+// a jako asynchronni predikaty, ktere na vice cteni dat cekaji soucasne (viz _async/async_predicate.h)
+using async_predicates_t = std::vector<async_predicate_t<test_row_t>>;
+
 
 // vygeneruje tabulku a dotaz v podobe konjunkce predikatu
 // expected - zda ma byt dotaz a data vygenerovana tak, ze dotaz je nad danymi daty pravdivy
@@ -23,6 +29,16 @@ std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>> generat
 // expected - zda ma byt dotaz a data vygenerovana tak, ze dotaz je nad danymi daty pravdivy
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>> generate_any(bool expected);
 
+// stejne tabulky a dotazy jako generate_all/generate_any, predikaty jsou ale zkompilovane columnar vyrazy.
+// ty ctou hodnoty primo z tabulky v pameti, simulace pomaleho cteni dat se u nich nepouziva
+std::pair<std::vector<test_row_t>, compiled_predicates_t> generate_all_compiled(bool expected);
+std::pair<std::vector<test_row_t>, compiled_predicates_t> generate_any_compiled(bool expected);
+
+// stejne tabulky a dotazy s asynchronnimi predikaty. kazde cteni dat trva stejne dlouho jako u generate_all/generate_any,
+// vlakno ale na nej neceka hned pri zadani a dalsi cteni se prekryvaji
+std::pair<std::vector<test_row_t>, async_predicates_t> generate_all_async(bool expected);
+std::pair<std::vector<test_row_t>, async_predicates_t> generate_any_async(bool expected);
+
 // typ logicke spojky - jak jsou jednotlive predikaty spojeny
 enum Operation {
     conjunction, disjunction
@@ -33,8 +49,20 @@ enum Operation {
 // is_query_evaluated_true - ma byt dotaz vzhledem k datum splnen
 // length_of_query - kolik bude v dotazu predikatu
 // count_of_rows - pocet radku v tabulce
+// compiled - pokud neni nullptr, prida se do nej kazdy predikat i jako zkompilovany vyraz
+// async - pokud neni nullptr, prida se do nej kazdy predikat i jako asynchronni predikat
+std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
+generate_instance_with_query(Operation operation, bool is_query_evaluated_true, const int length_of_query,
+                             const int count_of_rows, compiled_predicates_t *compiled = nullptr,
+                             async_predicates_t *async = nullptr);
+
+// totez s pravdepodobnosti pravdivosti predikatu a seedem zadanymi misto konstant z params.h
+// (t_probability_*_predicate a SEED), aby se dalo merit pres ruzne parametry bez prekladu (viz _sweep/sweep.cpp)
+// t_probability_predicate - pravdepodobnost, ze predikat bude pravdivy (pouziva se u konjunkce s vysledkem false
+//                           a disjunkce s vysledkem true, ostatni pripady maji pravdivost predikatu danou)
 std::pair<std::vector<test_row_t>, std::vector<predicate_t<test_row_t>>>
 generate_instance_with_query(Operation operation, bool is_query_evaluated_true, const int length_of_query,
-                             const int count_of_rows);
+                             const int count_of_rows, const double t_probability_predicate, const unsigned int seed,
+                             compiled_predicates_t *compiled = nullptr, async_predicates_t *async = nullptr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef DATABASEQUERIES_TILE_SCHEDULER_H
+#define DATABASEQUERIES_TILE_SCHEDULER_H
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Rozvrhovani dotazu po dlazdicich (predikat, usek radku). Dlazdice jsou ocislovane po predikatech:
+// dlazdice t patri predikatu t / chunks() a radkum [(t % chunks()) * tile_rows(), ...).
+// Kazde vlakno dostane na zacatku souvisly usek cisel dlazdic, bere si je od zacatku a po splneni
+// predikatu zbytek jeho dlazdic preskoci. Vlakno, kteremu prace dojde, ukradne druhou polovinu
+// useku jineho vlakna, takze se muze presunout i k predikatu, na kterem uz nekdo pracuje
+// (u malo predikatu se tak paralelizuje pres radky, u mnoha pres predikaty).
+//
+// Usek [lo, hi) kazdeho vlakna je jedno 64bitove slovo menene CAS, vlastnik i zlodej se tak
+// nemusi zamykat. Kazda dlazdice se vyda prave jednou, takze CAS nema problem ABA.
+// Predcasne ukonceni dotazu si resi volajici vlastnim priznakem (nezavisi na OMP_CANCELLATION).
+class tile_scheduler_t {
+public:
+    // Vychozi pocet radku na dlazdici, dlazdic celkem musi byt mene nez 2^32
+    static constexpr size_t TILE_ROWS = 256;
+
+    tile_scheduler_t(size_t predicate_count, size_t row_count, int threads, size_t tile_rows = TILE_ROWS)
+            : ranges(threads) {
+        rows_per_tile = std::max(tile_rows, predicate_count * row_count / UINT32_MAX + 1);
+        chunk_count = (row_count + rows_per_tile - 1) / rows_per_tile;
+        tile_count = predicate_count * chunk_count;
+
+        for (int thread = 0; thread < threads; thread++) {
+            ranges[thread].bounds.store(pack(tile_count * thread / threads, tile_count * (thread + 1) / threads));
+        }
+    }
+
+    size_t tile_rows() const { return rows_per_tile; }
+    size_t chunks() const { return chunk_count; }
+    size_t tiles() const { return tile_count; }
+
+    size_t predicate_of(size_t tile) const { return tile / chunk_count; }
+    size_t first_row_of(size_t tile) const { return tile % chunk_count * rows_per_tile; }
+
+    // Dalsi dlazdice pro vlakno 'thread' - z vlastniho useku, nebo ukradena. Vraci false,
+    // pokud uz zadne volne dlazdice nezbyvaji.
+    bool next(int thread, size_t &tile) {
+        std::atomic<uint64_t> &own = ranges[thread].bounds;
+        uint64_t bounds = own.load();
+        while (low(bounds) < high(bounds)) {
+            if (own.compare_exchange_weak(bounds, pack(low(bounds) + 1, high(bounds)))) {
+                tile = low(bounds);
+                return true;
+            }
+        }
+        return steal(thread, tile);
+    }
+
+    // Vlakno 'thread' preskoci zbyle dlazdice predikatu 'predicate', pokud jimi zacina jeho usek
+    // (po kradezi muze usek zacinat i drivejsim predikatem, ten se preskocit nesmi)
+    void skip_predicate(int thread, size_t predicate) {
+        std::atomic<uint64_t> &own = ranges[thread].bounds;
+        const size_t begin = predicate * chunk_count, end = begin + chunk_count;
+        uint64_t bounds = own.load();
+        while (begin <= low(bounds) && low(bounds) < end && low(bounds) < high(bounds)) {
+            if (own.compare_exchange_weak(bounds, pack(std::min<size_t>(end, high(bounds)), high(bounds)))) return;
+        }
+    }
+
+private:
+    // Zarovnani na cache line, aby se useky ruznych vlaken nesdilely
+    struct range_t {
+        std::atomic<uint64_t> bounds;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+
+        range_t() : bounds(0) {}
+    };
+
+    static uint64_t pack(size_t low, size_t high) { return static_cast<uint64_t>(high) << 32 | low; }
+    static size_t low(uint64_t bounds) { return static_cast<uint32_t>(bounds); }
+    static size_t high(uint64_t bounds) { return static_cast<size_t>(bounds >> 32); }
+
+    // Obeti jsou ostatni vlakna postupne od souseda. Zlodej si vezme prvni dlazdici druhe
+    // poloviny useku obeti a zbytek poloviny si ulozi jako svuj (prazdny) usek.
+    bool steal(int thread, size_t &tile) {
+        const int threads = static_cast<int>(ranges.size());
+        for (int i = 1; i < threads; i++) {
+            std::atomic<uint64_t> &victim = ranges[(thread + i) % threads].bounds;
+            uint64_t bounds = victim.load();
+            while (low(bounds) < high(bounds)) {
+                const size_t middle = low(bounds) + (high(bounds) - low(bounds)) / 2;
+                if (victim.compare_exchange_weak(bounds, pack(low(bounds), middle))) {
+                    tile = middle;
+                    ranges[thread].bounds.store(pack(middle + 1, high(bounds)));
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::vector<range_t> ranges;
+    size_t rows_per_tile, chunk_count, tile_count;
+};
+
+#endif //DATABASEQUERIES_TILE_SCHEDULER_H
@@ -0,0 +1,99 @@
+#ifndef DATABASEQUERIES_QUERY_STATISTICS_H
+#define DATABASEQUERIES_QUERY_STATISTICS_H
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// Statistiky predikatu jednoho dotazu, ktere se prenaseji mezi jeho opakovanymi vyhodnocenimi.
+// Pro kazdy predikat (podle pozice v seznamu) si pamatujeme klouzave prumery:
+//   - jak casto predikat neplatil (pro zadny radek),
+//   - podil splnujicich radku (1 / pocet radku prectenych do prvniho zasahu),
+//   - cas jednoho vyhodnoceni (meri se jen kazde TIME_EVERY-te, mereni neni zadarmo).
+// Konjunkci rozhodne prvni neplatny predikat, proto se vyhodnocuji nejdrive predikaty s nejvetsi
+// pravdepodobnosti neplatnosti na jednotku casu. Klouzave prumery (vaha ALPHA) rychle zapominaji,
+// takze se poradi prizpusobi i datum, jejichz selektivita se v case meni.
+//
+// Zapis do statistik jednoho predikatu dela jen vlakno, ktere ho prave vyhodnocuje, poradi se
+// pocita mimo paralelni cast.
+class query_statistics_t {
+public:
+    static constexpr double ALPHA = 0.3;
+    static constexpr unsigned TIME_EVERY = 8;
+    // Predikaty s mensi odhadnutou pravdepodobnosti neplatnosti zustavaji v puvodnim poradi
+    static constexpr double SUSPECT_PROBABILITY = 1e-3;
+
+    explicit query_statistics_t(size_t predicate_count = 0) : entries(predicate_count) {}
+
+    // Seznam predikatu se zmenil, statistiky nove pozice zacinaji od nuly
+    void resize(size_t predicate_count) {
+        if (entries.size() != predicate_count) entries.assign(predicate_count, entry_t());
+    }
+
+    size_t size() const { return entries.size(); }
+
+    // Odhad pravdepodobnosti, ze predikat nebude platit pro tabulku o 'row_count' radcich
+    double failure_probability(size_t predicate, size_t row_count) const {
+        const entry_t &e = entries[predicate];
+        if (e.evaluations == 0) return 0;
+        // Pri podilu splnujicich radku h nema zadny z n radku zasah s pravdepodobnosti ~ e^(-h n)
+        return std::max(e.fail_rate, std::exp(-e.hit_rate * static_cast<double>(row_count)));
+    }
+
+    // Poradi vyhodnocovani konjunkce: podezrele predikaty serazene podle pravdepodobnosti
+    // neplatnosti na sekundu, za nimi ostatni v puvodnim poradi
+    std::vector<uint32_t> conjunction_order(size_t row_count) const {
+        std::vector<uint32_t> order(entries.size());
+        std::iota(order.begin(), order.end(), 0u);
+
+        std::vector<double> priority(entries.size(), 0.0);
+        const auto suspects_end = std::stable_partition(order.begin(), order.end(), [&](uint32_t p) {
+            const double probability = failure_probability(p, row_count);
+            if (probability < SUSPECT_PROBABILITY) return false;
+            priority[p] = probability / std::max(entries[p].cost, 1e-9);
+            return true;
+        });
+        std::stable_sort(order.begin(), suspects_end, [&](uint32_t a, uint32_t b) {
+            return priority[a] > priority[b];
+        });
+        return order;
+    }
+
+    // Ma se toto vyhodnoceni predikatu merit?
+    bool should_time(size_t predicate) const {
+        return entries[predicate].evaluations % TIME_EVERY == 0;
+    }
+
+    // Vysledek jednoho uplneho vyhodnoceni. 'scanned' je pocet prectenych radku (pri zasahu vcetne
+    // splnujiciho), 'seconds' je zaporne, pokud se nemerilo.
+    void record(size_t predicate, bool satisfied, size_t scanned, double seconds) {
+        entry_t &e = entries[predicate];
+        const double failed = satisfied ? 0.0 : 1.0;
+        const double hit = satisfied ? 1.0 / static_cast<double>(std::max<size_t>(scanned, 1)) : 0.0;
+
+        if (e.evaluations == 0) {
+            e.fail_rate = failed;
+            e.hit_rate = hit;
+        } else {
+            e.fail_rate += ALPHA * (failed - e.fail_rate);
+            e.hit_rate += ALPHA * (hit - e.hit_rate);
+        }
+        if (seconds >= 0) e.cost = e.cost > 0 ? e.cost + ALPHA * (seconds - e.cost) : seconds;
+        e.evaluations++;
+    }
+
+private:
+    struct entry_t {
+        double fail_rate = 0;
+        double hit_rate = 0;
+        double cost = 0;            // Sekundy na vyhodnoceni, 0 = jeste nemereno
+        unsigned evaluations = 0;
+    };
+
+    std::vector<entry_t> entries;
+};
+
+#endif //DATABASEQUERIES_QUERY_STATISTICS_H
@@ -0,0 +1,301 @@
+// Mereni dotazu pres ruzne parametry bez prekladu. Kazdy parametr muze mit vic hodnot (oddelenych carkou),
+// meri se vsechny kombinace. Pro kazdou kombinaci se dotaz spusti --trials krat a vypise se median casu
+// a jeho rozptyl (minimum, maximum a median absolutnich odchylek) jako CSV nebo JSON.
+//
+// Priklad:
+//     DatabaseSweep --query all --rows 10000,100000 --predicates 100,10000 --engine tiles,predicates,rows
+//                   --threads 1,2,4,8 --seeds 1,2,3 --trials 5 --format csv > sweep.csv
+//
+// Neuvedene --rows a --predicates se berou z params.h podle typu dotazu, neuvedena --probability podle
+// t_probability_*_predicate. Generator pouziva stejnou simulaci pomaleho cteni jako main.cpp, velke tabulky
+// tak trvaji dlouho.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <omp.h>
+
+#include "../_generator/generator.h"
+#include "../params.h"
+
+// Jak se dotaz vyhodnocuje:
+//   tiles      - is_satisfied_for_all/any nad std::function (dlazdice predikat x usek radku, viz query.h)
+//   predicates - paralelne jen pres predikaty, kazde vlakno cte celou tabulku
+//   rows       - predikaty postupne, paralelne pres radky tabulky
+//   compiled   - zkompilovane predikaty (bez simulace pomaleho cteni)
+//   async      - asynchronni predikaty, --depth rozpracovanych kontrol na vlakno
+const char *const ENGINES[] = {"tiles", "predicates", "rows", "compiled", "async"};
+
+struct sweep_params_t {
+    std::vector<std::string> queries{"all"};
+    std::vector<bool> expected{true};
+    std::vector<int> rows, predicates;
+    std::vector<double> probabilities;
+    std::vector<int> threads{omp_get_max_threads()};
+    std::vector<unsigned int> seeds{SEED};
+    std::vector<std::string> engines{"tiles"};
+    size_t depth = 64;
+    int trials = 5;
+    std::string format = "csv";
+};
+
+struct sweep_result_t {
+    std::string query, engine;
+    bool expected, correct;
+    int rows, predicates, threads, trials;
+    double probability;
+    unsigned int seed;
+    double median_ms, min_ms, max_ms, mad_ms;
+};
+
+template<typename T>
+std::vector<T> parse_list(const std::string &text) {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::stringstream item_stream(item);
+        T value;
+        if (!(item_stream >> std::boolalpha >> value)) throw std::invalid_argument("bad value '" + item + "'");
+        values.push_back(value);
+    }
+    return values;
+}
+
+void print_usage() {
+    std::cerr << "usage: DatabaseSweep [--query all,any] [--expected true,false] [--rows N,...] [--predicates N,...]\n"
+                 "                     [--probability P,...] [--threads N,...] [--seeds N,...] [--trials N]\n"
+                 "                     [--engine tiles,predicates,rows,compiled,async] [--depth N] [--format csv|json]\n";
+}
+
+sweep_params_t parse_arguments(int argc, char **argv) {
+    sweep_params_t params;
+    for (int i = 1; i < argc; i++) {
+        const std::string name = argv[i];
+        if (name == "--help") {
+            print_usage();
+            std::exit(0);
+        }
+        if (i + 1 == argc) throw std::invalid_argument("missing value for " + name);
+        const std::string value = argv[++i];
+
+        if (name == "--query") params.queries = parse_list<std::string>(value);
+        else if (name == "--expected") params.expected = parse_list<bool>(value);
+        else if (name == "--rows") params.rows = parse_list<int>(value);
+        else if (name == "--predicates") params.predicates = parse_list<int>(value);
+        else if (name == "--probability") params.probabilities = parse_list<double>(value);
+        else if (name == "--threads") params.threads = parse_list<int>(value);
+        else if (name == "--seeds") params.seeds = parse_list<unsigned int>(value);
+        else if (name == "--engine") params.engines = parse_list<std::string>(value);
+        else if (name == "--depth") params.depth = parse_list<size_t>(value).at(0);
+        else if (name == "--trials") params.trials = parse_list<int>(value).at(0);
+        else if (name == "--format") params.format = value;
+        else throw std::invalid_argument("unknown option " + name);
+    }
+
+    for (const std::string &query : params.queries) {
+        if (query != "all" && query != "any") throw std::invalid_argument("unknown query " + query);
+    }
+    for (const std::string &engine : params.engines) {
+        if (std::find(std::begin(ENGINES), std::end(ENGINES), engine) == std::end(ENGINES)) {
+            throw std::invalid_argument("unknown engine " + engine);
+        }
+    }
+    if (params.format != "csv" && params.format != "json") throw std::invalid_argument("unknown format " + params.format);
+    if (params.trials < 1) throw std::invalid_argument("--trials must be positive");
+    return params;
+}
+
+// Paralelizace jen pres predikaty: vlakno hleda splnujici radek pro cely predikat
+bool predicate_parallel(bool conjunction, const std::vector<predicate_t<test_row_t>> &predicates,
+                        table_view_t<test_row_t> table) {
+    // Konjunkce: nalezen nesplneny predikat, disjunkce: nalezen splneny
+    std::atomic<bool> decided(false);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int predicate_index = 0; predicate_index < static_cast<int>(predicates.size()); predicate_index++) {
+        if (decided.load(std::memory_order_relaxed)) continue;
+        bool hit = false;
+        for (size_t i = 0; i < table.size() && !hit; i++) {
+            if (i % 64 == 0 && decided.load(std::memory_order_relaxed)) break;
+            hit = predicates[predicate_index](table[i]);
+        }
+        // Prerusene hledani bez nalezu je mozne jen po rozhodnuti, prepsani priznaku nevadi
+        if (hit != conjunction) decided.store(true);
+    }
+
+    return conjunction ? !decided.load() : decided.load();
+}
+
+// Paralelizace jen pres radky: predikaty jeden po druhem, kazdy vsemi vlakny
+bool row_parallel(bool conjunction, const std::vector<predicate_t<test_row_t>> &predicates,
+                  table_view_t<test_row_t> table) {
+    for (const predicate_t<test_row_t> &predicate : predicates) {
+        std::atomic<bool> hit(false);
+
+#pragma omp parallel for schedule(dynamic, 256)
+        for (int i = 0; i < static_cast<int>(table.size()); i++) {
+            if (hit.load(std::memory_order_relaxed)) continue;
+            if (predicate(table[i])) hit.store(true);
+        }
+
+        if (hit.load() != conjunction) return !conjunction;
+    }
+    return conjunction;
+}
+
+struct instance_t {
+    table_storage_t<test_row_t> table;
+    std::vector<predicate_t<test_row_t>> predicates;
+    compiled_predicates_t compiled;
+    async_predicates_t async;
+};
+
+bool run_query(const std::string &engine, bool conjunction, const instance_t &instance, size_t depth) {
+    const table_view_t<test_row_t> table = instance.table.view();
+    if (engine == "tiles") {
+        return conjunction ? is_satisfied_for_all<test_row_t>(instance.predicates, table)
+                           : is_satisfied_for_any<test_row_t>(instance.predicates, table);
+    }
+    if (engine == "predicates") return predicate_parallel(conjunction, instance.predicates, table);
+    if (engine == "rows") return row_parallel(conjunction, instance.predicates, table);
+    if (engine == "compiled") {
+        return conjunction ? is_satisfied_for_all<test_row_t>(instance.compiled, table)
+                           : is_satisfied_for_any<test_row_t>(instance.compiled, table);
+    }
+    return conjunction ? is_satisfied_for_all<test_row_t>(instance.async, table, depth)
+                       : is_satisfied_for_any<test_row_t>(instance.async, table, depth);
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+sweep_result_t measure(const std::string &engine, bool conjunction, bool expected, const instance_t &instance,
+                       size_t depth, int trials) {
+    using namespace std::chrono;
+
+    sweep_result_t result;
+    result.expected = expected;
+    result.correct = true;
+    std::vector<double> times;
+    for (int trial = 0; trial < trials; trial++) {
+        const auto begin = steady_clock::now();
+        const bool value = run_query(engine, conjunction, instance, depth);
+        times.push_back(duration<double, std::milli>(steady_clock::now() - begin).count());
+        result.correct = result.correct && value == result.expected;
+    }
+
+    result.median_ms = median(times);
+    result.min_ms = *std::min_element(times.begin(), times.end());
+    result.max_ms = *std::max_element(times.begin(), times.end());
+    std::vector<double> deviations;
+    for (double time : times) deviations.push_back(std::abs(time - result.median_ms));
+    result.mad_ms = median(deviations);
+    return result;
+}
+
+void print_csv_header() {
+    std::printf("query,expected,engine,rows,predicates,probability,threads,seed,trials,"
+                "median_ms,min_ms,max_ms,mad_ms,correct\n");
+}
+
+void print_csv(const sweep_result_t &r) {
+    std::printf("%s,%s,%s,%d,%d,%g,%d,%u,%d,%.3f,%.3f,%.3f,%.3f,%s\n", r.query.c_str(), r.expected ? "true" : "false",
+                r.engine.c_str(), r.rows, r.predicates, r.probability, r.threads, r.seed, r.trials,
+                r.median_ms, r.min_ms, r.max_ms, r.mad_ms, r.correct ? "true" : "false");
+}
+
+void print_json(const sweep_result_t &r, bool first) {
+    std::printf("%s\n  {\"query\": \"%s\", \"expected\": %s, \"engine\": \"%s\", \"rows\": %d, \"predicates\": %d, "
+                "\"probability\": %g, \"threads\": %d, \"seed\": %u, \"trials\": %d, \"median_ms\": %.3f, "
+                "\"min_ms\": %.3f, \"max_ms\": %.3f, \"mad_ms\": %.3f, \"correct\": %s}",
+                first ? "" : ",", r.query.c_str(), r.expected ? "true" : "false", r.engine.c_str(), r.rows,
+                r.predicates, r.probability, r.threads, r.seed, r.trials, r.median_ms, r.min_ms, r.max_ms, r.mad_ms,
+                r.correct ? "true" : "false");
+}
+
+int main(int argc, char **argv) {
+    sweep_params_t params;
+    try {
+        params = parse_arguments(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    const bool json = params.format == "json";
+    if (json) std::printf("[");
+    else print_csv_header();
+    bool first = true;
+
+    for (const std::string &query : params.queries) {
+        const bool conjunction = query == "all";
+        for (const bool expected : params.expected) {
+            // Vychozi velikosti z params.h podle typu dotazu
+            const std::vector<int> rows = !params.rows.empty() ? params.rows : std::vector<int>{
+                    conjunction ? (expected ? count_of_rows_all_true : count_of_rows_all_false)
+                                : (expected ? count_of_rows_any_true : count_of_rows_any_false)};
+            const std::vector<int> predicates = !params.predicates.empty() ? params.predicates : std::vector<int>{
+                    conjunction ? (expected ? length_of_query_all_true : length_of_query_all_false)
+                                : (expected ? length_of_query_any_true : length_of_query_any_false)};
+            const std::vector<double> probabilities = !params.probabilities.empty() ? params.probabilities
+                    : std::vector<double>{conjunction ? t_probability_conjunction_predicate
+                                                      : t_probability_disjunction_predicate};
+
+            for (const int row_count : rows)
+            for (const int predicate_count : predicates)
+            for (const double probability : probabilities)
+            for (const unsigned int seed : params.seeds) {
+                instance_t instance;
+                try {
+                    auto generated = generate_instance_with_query(conjunction ? Operation::conjunction : Operation::disjunction,
+                                                                  expected, predicate_count, row_count, probability, seed,
+                                                                  &instance.compiled, &instance.async);
+                    instance.table = table_storage_t<test_row_t>(std::move(generated.first));
+                    instance.predicates = std::move(generated.second);
+                } catch (const std::exception &e) {
+                    std::cerr << "skipping rows=" << row_count << " predicates=" << predicate_count << ": "
+                              << e.what() << std::endl;
+                    continue;
+                }
+
+                for (const std::string &engine : params.engines)
+                for (const int threads : params.threads) {
+                    omp_set_num_threads(threads);
+                    // Prvni paralelni region s novym poctem vlaken vlakna teprve vytvori, do mereni nepatri
+#pragma omp parallel
+                    {}
+
+                    sweep_result_t result = measure(engine, conjunction, expected, instance, params.depth, params.trials);
+                    result.query = query;
+                    result.engine = engine;
+                    result.rows = row_count;
+                    result.predicates = predicate_count;
+                    result.probability = probability;
+                    result.threads = threads;
+                    result.seed = seed;
+                    result.trials = params.trials;
+
+                    if (json) print_json(result, first);
+                    else print_csv(result);
+                    std::fflush(stdout);
+                    first = false;
+                }
+            }
+        }
+    }
+
+    if (json) std::printf("\n]\n");
+    return 0;
+}
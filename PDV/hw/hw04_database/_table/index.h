@@ -0,0 +1,92 @@
+#ifndef DATABASEQUERIES_INDEX_H
+#define DATABASEQUERIES_INDEX_H
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "table.h"
+
+// Sekundarni index sloupce: hodnoty vsech radku serazene vzestupne. Cisla radku si nepamatuje,
+// dotazy potrebuji jen hodnoty.
+// Dotaz "ma nektery radek hodnotu z intervalu [low, high]?" je pak binarni hledani.
+template<typename row_t>
+class sorted_index_t {
+    static_assert(std::is_arithmetic<row_t>::value, "Only single-column tables of numbers can be indexed");
+
+public:
+    sorted_index_t() {}
+
+    explicit sorted_index_t(table_view_t<row_t> table) : values(table.data(), table.data() + table.size()) {
+        std::sort(values.begin(), values.end());
+    }
+
+    bool empty() const { return values.empty(); }
+
+    // Serazene hodnoty z intervalu [low, high] (jako tabulka, nad kterou lze vyhodnotit predikat)
+    table_view_t<row_t> values_between(row_t low, row_t high) const {
+        if (low > high) return table_view_t<row_t>();
+        const size_t first = std::lower_bound(values.begin(), values.end(), low) - values.begin();
+        const size_t last = std::upper_bound(values.begin() + first, values.end(), high) - values.begin();
+        return table_view_t<row_t>(span_t<const row_t>(values.data() + first, last - first));
+    }
+
+private:
+    std::vector<row_t> values;
+};
+
+// Zone mapa: minimum a maximum hodnot v kazdem bloku ZONE_ROWS radku. Blok, jehoz rozsah
+// [min, max] se s intervalem predikatu neprotina, se nemusi cist. Pomaha u dat, ktera jsou
+// alespon castecne serazena nebo shlukovana, u nahodne zamichanych dat vetsinou nic neusetri.
+template<typename row_t>
+class zone_map_t {
+    static_assert(std::is_arithmetic<row_t>::value, "Zone maps are kept for single-column tables of numbers");
+
+public:
+    static constexpr size_t ZONE_ROWS = 1024;
+
+    zone_map_t() {}
+
+    explicit zone_map_t(table_view_t<row_t> table) {
+        for (size_t begin = 0; begin < table.size(); begin += ZONE_ROWS) {
+            const size_t end = std::min(begin + ZONE_ROWS, table.size());
+            row_t low = table[begin], high = table[begin];
+            for (size_t i = begin + 1; i < end; i++) {
+                low = std::min(low, table[i]);
+                high = std::max(high, table[i]);
+            }
+            minimum.push_back(low);
+            maximum.push_back(high);
+        }
+    }
+
+    bool empty() const { return minimum.empty(); }
+    size_t zones() const { return minimum.size(); }
+
+    row_t min(size_t zone) const { return minimum[zone]; }
+    row_t max(size_t zone) const { return maximum[zone]; }
+
+private:
+    std::vector<row_t> minimum, maximum;
+};
+
+template<typename row_t>
+constexpr size_t zone_map_t<row_t>::ZONE_ROWS;
+
+// Tabulka (pohled) spolu s volitelnymi pomocnymi strukturami, ktere se postavi jednou a pak
+// slouzi vsem dotazum. Tabulka se nemeni, dokud se indexy pouzivaji.
+template<typename row_t>
+class table_indexes_t {
+public:
+    table_view_t<row_t> table;
+    sorted_index_t<row_t> index;
+    zone_map_t<row_t> zone_map;
+
+    explicit table_indexes_t(table_view_t<row_t> table, bool with_index = true, bool with_zone_map = true)
+            : table(table) {
+        if (with_index) index = sorted_index_t<row_t>(table);
+        if (with_zone_map) zone_map = zone_map_t<row_t>(table);
+    }
+};
+
+#endif //DATABASEQUERIES_INDEX_H
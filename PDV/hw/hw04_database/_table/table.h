@@ -0,0 +1,93 @@
+#ifndef DATABASEQUERIES_TABLE_H
+#define DATABASEQUERIES_TABLE_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+// Nevlastnici pohled na souvisle pole prvku (obdoba std::span z C++20). Predava se hodnotou, kopiruje
+// se jen ukazatel a delka. Pole musi existovat dele nez pohled.
+template<typename T>
+class span_t {
+public:
+    typedef typename std::remove_const<T>::type value_type;
+
+    span_t() : pointer(nullptr), length(0) {}
+
+    span_t(T *pointer, size_t length) : pointer(pointer), length(length) {}
+
+    span_t(std::vector<value_type> &vector) : pointer(vector.data()), length(vector.size()) {}
+
+    // Jen pro span_t<const T>
+    span_t(const std::vector<value_type> &vector) : pointer(vector.data()), length(vector.size()) {}
+
+    T *data() const { return pointer; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    T &operator[](size_t index) const { return pointer[index]; }
+
+    T *begin() const { return pointer; }
+    T *end() const { return pointer + length; }
+
+    // Usek [offset, offset + count), 'count' se zkrati na konec pole
+    span_t subspan(size_t offset, size_t count) const {
+        if (offset > length) offset = length;
+        return span_t(pointer + offset, count < length - offset ? count : length - offset);
+    }
+
+private:
+    T *pointer;
+    size_t length;
+};
+
+// Nevlastnici pohled na tabulku. Dotazy dostavaji tabulku timto pohledem, takze se pri volani
+// nic nekopiruje. Radek test_row_t je jedno cislo, pole radku je tedy zaroven jedinym sloupcem
+// tabulky a zkompilovane predikaty (viz _columnar/predicate.h) ho ctou primo.
+template<typename row_t>
+class table_view_t {
+public:
+    table_view_t() {}
+
+    explicit table_view_t(span_t<const row_t> rows) : rows(rows) {}
+
+    table_view_t(const std::vector<row_t> &rows) : rows(rows) {}
+
+    size_t size() const { return rows.size(); }
+    const row_t &operator[](size_t index) const { return rows[index]; }
+
+    // Souvisle pole vsech radku
+    const row_t *data() const { return rows.data(); }
+
+    // Pohled jen na radky [begin, begin + count)
+    table_view_t slice(size_t begin, size_t count) const {
+        return table_view_t(rows.subspan(begin, count));
+    }
+
+private:
+    span_t<const row_t> rows;
+};
+
+// Tabulka, ktera vlastni sva data. Da se jen presouvat, ke cteni slouzi view().
+template<typename row_t>
+class table_storage_t {
+public:
+    table_storage_t() {}
+
+    explicit table_storage_t(std::vector<row_t> rows) : rows(std::move(rows)) {}
+
+    table_storage_t(const table_storage_t &) = delete;
+    table_storage_t &operator=(const table_storage_t &) = delete;
+    table_storage_t(table_storage_t &&) = default;
+    table_storage_t &operator=(table_storage_t &&) = default;
+
+    size_t size() const { return rows.size(); }
+
+    table_view_t<row_t> view() const { return table_view_t<row_t>(rows); }
+
+private:
+    std::vector<row_t> rows;
+};
+
+#endif //DATABASEQUERIES_TABLE_H
@@ -1,10 +1,15 @@
 #ifndef DATABASEQUERY_TESTS_H
 #define DATABASEQUERY_TESTS_H
 
+#include <random>
+#include <numeric>
+#include <algorithm>
+
 #include "../_generator/generator.h"
 #include "../query.h"
 
-typedef std::vector<test_row_t> table_t;
+// Testy tabulku vlastni, dotazy dostavaji jen jeji pohled (table_storage_t nejde zkopirovat)
+typedef table_storage_t<test_row_t> table_t;
 typedef std::vector<predicate_t<test_row_t>> predicates_t;
 
 template <bool result>
@@ -15,7 +20,7 @@ public:
 
 	TestAll() : test_data(generate_all(result)) {}
 	void run_test() {
-		computed_result = is_satisfied_for_all(test_data.second, test_data.first);
+		computed_result = is_satisfied_for_all<test_row_t>(test_data.second, test_data.first.view());
 	}
 	bool verify() {
 		return computed_result == result;
@@ -30,11 +35,164 @@ public:
 
 	TestAny() : test_data(generate_any(result)) {}
 	void run_test() {
-		computed_result = is_satisfied_for_any(test_data.second, test_data.first);
+		computed_result = is_satisfied_for_any<test_row_t>(test_data.second, test_data.first.view());
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+// Stejne dotazy nad zkompilovanymi predikaty (columnar vyrazy, viz _columnar/expression.h)
+template <bool result>
+class TestAllCompiled {
+public:
+	std::pair<table_t, compiled_predicates_t> test_data;
+	bool computed_result;
+
+	TestAllCompiled() : test_data(generate_all_compiled(result)) {}
+	void run_test() {
+		computed_result = is_satisfied_for_all<test_row_t>(test_data.second, test_data.first.view());
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+template <bool result>
+class TestAnyCompiled {
+public:
+	std::pair<table_t, compiled_predicates_t> test_data;
+	bool computed_result;
+
+	TestAnyCompiled() : test_data(generate_any_compiled(result)) {}
+	void run_test() {
+		computed_result = is_satisfied_for_any<test_row_t>(test_data.second, test_data.first.view());
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+// Zkompilovane predikaty nad tabulkou s indexem a zone mapou. Ty se postavi jednou pri vytvoreni
+// testu, do casu dotazu se nepocitaji.
+template <bool result>
+class TestAllIndexed {
+public:
+	std::pair<table_t, compiled_predicates_t> test_data;
+	table_indexes_t<test_row_t> indexes;
+	bool computed_result;
+
+	TestAllIndexed() : test_data(generate_all_compiled(result)), indexes(test_data.first.view()) {}
+	void run_test() {
+		computed_result = is_satisfied_for_all(test_data.second, indexes);
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+template <bool result>
+class TestAnyIndexed {
+public:
+	std::pair<table_t, compiled_predicates_t> test_data;
+	table_indexes_t<test_row_t> indexes;
+	bool computed_result;
+
+	TestAnyIndexed() : test_data(generate_any_compiled(result)), indexes(test_data.first.view()) {}
+	void run_test() {
+		computed_result = is_satisfied_for_any(test_data.second, indexes);
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+// Asynchronni predikaty (viz _async/async_predicate.h): kazde vlakno ma rozpracovanych az 'depth'
+// kontrol radku, kazde cteni trva stejne dlouho jako u TestAll/TestAny, vlakno ale ceka na vsechna soucasne
+template <bool result, size_t depth>
+class TestAllAsync {
+public:
+	std::pair<table_t, async_predicates_t> test_data;
+	bool computed_result;
+
+	TestAllAsync() : test_data(generate_all_async(result)) {}
+	void run_test() {
+		computed_result = is_satisfied_for_all<test_row_t>(test_data.second, test_data.first.view(), depth);
+	}
+	bool verify() {
+		return computed_result == result;
+	}
+};
+
+template <bool result, size_t depth>
+class TestAnyAsync {
+public:
+	std::pair<table_t, async_predicates_t> test_data;
+	bool computed_result;
+
+	TestAnyAsync() : test_data(generate_any_async(result)) {}
+	void run_test() {
+		computed_result = is_satisfied_for_any<test_row_t>(test_data.second, test_data.first.view(), depth);
 	}
 	bool verify() {
 		return computed_result == result;
 	}
 };
 
+// Opakovane konjunktivni dotazy nad tabulkou, jejiz hodnoty se kazde kolo posunou o DRIFT, takze
+// se meni selektivita predikatu u spodniho okraje dat. Predikaty jsou uzke intervaly a ty, ktere
+// z rozsahu dat vypadnou, rozhodnou dotaz jako false. S adaptive = true se mezi koly prenasi
+// query_statistics_t, jinak dostane kazde kolo nove statistiky (predikaty v puvodnim poradi).
+template <bool adaptive>
+class TestAllDrifting {
+public:
+	static constexpr int ROUNDS = 32;
+	static constexpr int ROWS = 100000;
+	static constexpr int PREDICATES = 20000;
+	static constexpr int WIDTH = 8;
+	static constexpr int DRIFT = 50;
+
+	// Hodnoty tabulky se mezi koly meni, zustava proto obycejnym vektorem
+	std::vector<test_row_t> table;
+	predicates_t predicates;
+	std::vector<int> lows;
+	query_statistics_t statistics;
+	std::vector<bool> computed_results;
+
+	TestAllDrifting() : table(ROWS), lows(PREDICATES) {
+		std::mt19937 random(2024);
+		std::iota(table.begin(), table.end(), DRIFT);
+		std::shuffle(table.begin(), table.end(), random);
+
+		std::uniform_int_distribution<int> low(0, ROWS - WIDTH);
+		for (int &l : lows) {
+			l = low(random);
+			const int h = l + WIDTH;
+			predicates.push_back([l, h](const test_row_t &v) { return v >= l && v <= h; });
+		}
+	}
+	void run_test() {
+		for (int round = 0; round < ROUNDS; round++) {
+			if (round != 0) {
+				for (test_row_t &v : table) v += DRIFT;
+			}
+			if (adaptive) {
+				computed_results.push_back(is_satisfied_for_all(predicates, table, statistics));
+			} else {
+				query_statistics_t fresh;
+				computed_results.push_back(is_satisfied_for_all(predicates, table, fresh));
+			}
+		}
+	}
+	bool verify() {
+		// V kole r jsou v tabulce prave hodnoty [(r + 1) * DRIFT, (r + 1) * DRIFT + ROWS)
+		for (int round = 0; round < ROUNDS; round++) {
+			const int min = (round + 1) * DRIFT;
+			const bool expected = std::all_of(lows.begin(), lows.end(), [min](int l) { return l + WIDTH >= min; });
+			if (computed_results[round] != expected) return false;
+		}
+		return true;
+	}
+};
+
 #endif
\ No newline at end of file
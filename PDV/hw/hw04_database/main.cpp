@@ -1,10 +1,28 @@
 #include <iostream>
 #include <string>
 #include <chrono>
-#include <omp.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
 #include "_tests/tests.h"
 
+// Pocitadlo bajtu alokovanych na halde. Sloupec "B allocated" nahrazuje puvodne pozadovane "zkopirovane
+// bajty", ty se samostatne nemeri. Tabulku testy drzi v table_storage_t, ktery nejde zkopirovat, a dotazy
+// dostavaji tabulku i predikaty jako pohledy, kopii tabulky tak vylouci uz prekladac. Rozdil pred a po
+// dotazu udava vsechny alokace behem dotazu, vcetne pomocnych struktur implementace (napr. rozvrhovace).
+static std::atomic<unsigned long long> allocated_bytes(0);
+
+void *operator new(size_t size) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size != 0 ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
 template<class Test>
 void eval(std::string test_name) {
     using namespace std::chrono;
@@ -13,18 +31,21 @@ void eval(std::string test_name) {
     Test test;
 
     try {
+        const unsigned long long allocated_before = allocated_bytes.load();
         // Cas zacatku behu testu
         auto begin = steady_clock::now();
         // Beh testu
         test.run_test();
         // Konec behu testu
         auto end = steady_clock::now();
+        const unsigned long long allocated = allocated_bytes.load() - allocated_before;
 
         // Kontrola spravnosti vysledku
         if (!test.verify()) {
             printf("%s       --- wrong result ---\n", test_name.c_str());
         } else {
-            printf("%s          %7lldms\n", test_name.c_str(), duration_cast<milliseconds>(end - begin).count());
+            printf("%s          %7lldms   %10llu B allocated\n", test_name.c_str(),
+                   static_cast<long long>(duration_cast<milliseconds>(end - begin).count()), allocated);
         }
     } catch (...) {
         printf("%s      --- not implemented ---\n", test_name.c_str());
@@ -32,13 +53,9 @@ void eval(std::string test_name) {
 }
 
 int main() {
-    if (!omp_get_cancellation()) {
-        std::cout << "-----------------------------------------------------------------------------" << std::endl;
-        std::cout << "| WARNING: OpenMP cancellations are not enabled                             |" << std::endl;
-        std::cout << "| You can enable them by setting environment variable OMP_CANCELLATION=true |" << std::endl;
-        std::cout << "-----------------------------------------------------------------------------" << std::endl
-                  << std::endl;
-    }
+    // OpenMP si pri prvnim paralelnim regionu alokuje vlakna, to nechceme pocitat prvnimu dotazu
+#pragma omp parallel
+    {}
 
     // V tomto testovacim pripade testujeme rychlost vyhodnocovani dotazu typu:
     //  "Jsou vsechny dilci dotazy splnene?"
@@ -62,6 +79,39 @@ int main() {
     eval<TestAll<false>>("false = is_satisfied_for_all(...)");
     eval<TestAny<false>>("false = is_satisfied_for_any(...)");
 
+    // Tytez dotazy, predikaty jsou ale zkompilovane vyrazy vyhodnocovane po blocich radku
+    // (bez simulace pomaleho cteni dat, viz _columnar/expression.h)
+    std::cout << std::endl;
+    eval<TestAllCompiled<true>>("true = is_satisfied_for_all(compiled)");
+    eval<TestAnyCompiled<true>>("true = is_satisfied_for_any(compiled)");
+    eval<TestAllCompiled<false>>("false = is_satisfied_for_all(compiled)");
+    eval<TestAnyCompiled<false>>("false = is_satisfied_for_any(compiled)");
+
+    // Zkompilovane predikaty s indexem (binarni hledani intervalu predikatu misto pruchodu tabulky)
+    std::cout << std::endl;
+    eval<TestAllIndexed<true>>("true = is_satisfied_for_all(indexed)");
+    eval<TestAnyIndexed<true>>("true = is_satisfied_for_any(indexed)");
+    eval<TestAllIndexed<false>>("false = is_satisfied_for_all(indexed)");
+    eval<TestAnyIndexed<false>>("false = is_satisfied_for_any(indexed)");
+
+    // Asynchronni predikaty se simulovanym cekanim na data (vlakno ceka na vice cteni soucasne)
+    // pri 16 az 256 rozpracovanych kontrolach na vlakno
+    std::cout << std::endl;
+    eval<TestAllAsync<true, 16>>("true = is_satisfied_for_all(async,  16)");
+    eval<TestAllAsync<true, 64>>("true = is_satisfied_for_all(async,  64)");
+    eval<TestAllAsync<true, 256>>("true = is_satisfied_for_all(async, 256)");
+    eval<TestAnyAsync<true, 16>>("true = is_satisfied_for_any(async,  16)");
+    eval<TestAnyAsync<true, 64>>("true = is_satisfied_for_any(async,  64)");
+    eval<TestAnyAsync<true, 256>>("true = is_satisfied_for_any(async, 256)");
+    eval<TestAllAsync<false, 64>>("false = is_satisfied_for_all(async, 64)");
+    eval<TestAnyAsync<false, 64>>("false = is_satisfied_for_any(async, 64)");
+
+    // Opakovane dotazy s menici se selektivitou: poradi predikatu podle statistik z predchozich
+    // dotazu vs. puvodni poradi
+    std::cout << std::endl;
+    eval<TestAllDrifting<true>>("drifting is_satisfied_for_all(adaptive order)");
+    eval<TestAllDrifting<false>>("drifting is_satisfied_for_all(input order)   ");
+
     // Parametry generovani dat si muzete upravit v souboru params.h
 
     return 0;
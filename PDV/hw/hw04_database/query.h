@@ -4,17 +4,132 @@
 #include <vector>
 #include <functional>
 #include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <omp.h>
+
+#include "_columnar/predicate.h"
+#include "_table/table.h"
+#include "_table/index.h"
+#include "_statistics/query_statistics.h"
+#include "_scheduler/tile_scheduler.h"
+#include "_async/async_predicate.h"
 
 template<typename row_t>
 using predicate_t = std::function<bool(const row_t &)>;
 
+template<typename row_t>
+using compiled_predicate_t = columnar::compiled_predicate_t<row_t>;
+
+// Dotazy dostavaji predikaty i tabulku jako nevlastnici pohledy (viz _table/table.h), nic se
+// pri volani nekopiruje
+template<typename row_t>
+using predicates_view_t = span_t<const predicate_t<row_t>>;
+
+template<typename row_t>
+using compiled_predicates_view_t = span_t<const compiled_predicate_t<row_t>>;
+
+template<typename row_t>
+using async_predicates_view_t = span_t<const async_predicate_t<row_t>>;
+
+
+
+template<typename row_t>
+bool is_satisfied_for_all(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table);
+
+template<typename row_t>
+bool is_satisfied_for_any(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table);
+
+// Stejne dotazy nad predikaty z columnar::compile (viz _columnar/expression.h). Radky se
+// vyhodnocuji po blocich do bitmap, vetsi prace se deli jen mezi predikaty.
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table);
+
+template<typename row_t>
+bool is_satisfied_for_any(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table);
+
+// Totez s pomoci indexu a zone map postavenych predem nad tabulkou (viz _table/index.h).
+// Nepruhledne predikaty (std::function) se vyhodnoti linearnim pruchodem jako vyse.
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, const table_indexes_t<row_t> &data_table);
+
+template<typename row_t>
+bool is_satisfied_for_any(compiled_predicates_view_t<row_t> predicates, const table_indexes_t<row_t> &data_table);
+
+// Konjunkce, ktera vyhodnocuje nejdrive predikaty, jez podle statistik z predchozich dotazu
+// nejspis neplati (viz _statistics/query_statistics.h). Pri opakovanych dotazech se predava stale
+// stejny objekt 'statistics', vyhodnoceni ho prubezne aktualizuje.
+template<typename row_t>
+bool is_satisfied_for_all(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table,
+                          query_statistics_t &statistics);
+
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table,
+                          query_statistics_t &statistics);
+
+// Dotazy nad asynchronnimi predikaty (viz _async/async_predicate.h). Kazde vlakno ma rozpracovanych
+// az 'depth' kontrol radku naraz a na jejich vysledky ceka soucasne (viz completion_queue_t::wait).
+template<typename row_t>
+bool is_satisfied_for_all(async_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table, size_t depth);
+
+template<typename row_t>
+bool is_satisfied_for_any(async_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table, size_t depth);
+
+// Pohodlnejsi volani primo s vektory, vytvori jen pohledy
+template<typename row_t>
+bool is_satisfied_for_all(const std::vector<predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table) {
+    return is_satisfied_for_all(predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table));
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(const std::vector<predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table) {
+    return is_satisfied_for_any(predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table));
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(const std::vector<compiled_predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table) {
+    return is_satisfied_for_all(compiled_predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table));
+}
 
+template<typename row_t>
+bool is_satisfied_for_any(const std::vector<compiled_predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table) {
+    return is_satisfied_for_any(compiled_predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table));
+}
 
 template<typename row_t>
-bool is_satisfied_for_all(std::vector<predicate_t<row_t>> predicates, std::vector<row_t> data_table);
+bool is_satisfied_for_all(const std::vector<predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table,
+                          query_statistics_t &statistics) {
+    return is_satisfied_for_all(predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table), statistics);
+}
 
 template<typename row_t>
-bool is_satisfied_for_any(std::vector<predicate_t<row_t>> predicates, std::vector<row_t> data_table);
+bool is_satisfied_for_all(const std::vector<compiled_predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table,
+                          query_statistics_t &statistics) {
+    return is_satisfied_for_all(compiled_predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table),
+                                statistics);
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(const std::vector<async_predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table,
+                          size_t depth) {
+    return is_satisfied_for_all(async_predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table), depth);
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(const std::vector<async_predicate_t<row_t>> &predicates, const std::vector<row_t> &data_table,
+                          size_t depth) {
+    return is_satisfied_for_any(async_predicates_view_t<row_t>(predicates), table_view_t<row_t>(data_table), depth);
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(const std::vector<compiled_predicate_t<row_t>> &predicates, const table_indexes_t<row_t> &data_table) {
+    return is_satisfied_for_all(compiled_predicates_view_t<row_t>(predicates), data_table);
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(const std::vector<compiled_predicate_t<row_t>> &predicates, const table_indexes_t<row_t> &data_table) {
+    return is_satisfied_for_any(compiled_predicates_view_t<row_t>(predicates), data_table);
+}
 
 
 /*
@@ -35,97 +150,411 @@ bool is_satisfied_for_any(std::vector<predicate_t<row_t>> predicates, std::vecto
 
 
 template<typename row_t>
-bool is_satisfied_for_all(std::vector<predicate_t<row_t>> predicates, std::vector<row_t> data_table) {
+bool is_satisfied_for_all(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table) {
     // Doimplementujte telo funkce, ktera rozhodne, zda pro VSECHNY dilci dotazy (obsazene ve
     // vektoru 'predicates') existuje alespon jeden zaznam v tabulce (reprezentovane vektorem
     // 'data_table'), pro ktery je dany predikat splneny.
 
-    // Pro inspiraci si prostudujte kod, kterym muzete zjistit, zda prvni dilci dotaz plati,
-    // tj., zda existuje alespon jeden radek v tabulce, pro ktery predikat reprezentovany
-    // funkci predicates[i] plati:
-
-    bool return_value = true;
+    if (data_table.size() == 0) return predicates.empty();
+
+    // Prace se deli po dlazdicich (predikat, usek radku), viz _scheduler/tile_scheduler.h. Predikat
+    // je splneny, jakmile radek najde kterakoliv jeho dlazdice. Nesplneny je, az vsechny jeho
+    // dlazdice doberou bez nalezu ('pending' klesne na nulu) - to rozhodne cely dotaz.
+    const int threads = omp_get_max_threads();
+    tile_scheduler_t scheduler(predicates.size(), data_table.size(), threads);
+    std::vector<std::atomic<bool>> satisfied(predicates.size());
+    std::vector<std::atomic<uint32_t>> pending(predicates.size());
+    for (size_t i = 0; i < predicates.size(); i++) {
+        satisfied[i].store(false, std::memory_order_relaxed);
+        pending[i].store(static_cast<uint32_t>(scheduler.chunks()), std::memory_order_relaxed);
+    }
+    std::atomic<bool> failed(false);
+
+#pragma omp parallel num_threads(threads)
+    {
+        const int thread = omp_get_thread_num();
+        size_t tile;
+
+        while (!failed.load(std::memory_order_relaxed) && scheduler.next(thread, tile)) {
+            const size_t predicate_index = scheduler.predicate_of(tile);
+            if (satisfied[predicate_index].load(std::memory_order_relaxed)) {
+                scheduler.skip_predicate(thread, predicate_index);
+                continue;
+            }
 
-#pragma omp parallel
-#pragma omp for
-    for(int predicate_index = 0; predicate_index < predicates.size(); predicate_index++) {
+            auto &predicate = predicates[predicate_index];
+            const size_t begin = scheduler.first_row_of(tile);
+            const size_t end = std::min(begin + scheduler.tile_rows(), data_table.size());
+            bool is_one_satisfied = false;
+
+            for (size_t i = begin; i < end; i++) {
+                // Jine vlakno uz predikat splnilo nebo dotaz rozhodlo
+                if ((i - begin) % 32 == 0 && (satisfied[predicate_index].load(std::memory_order_relaxed) ||
+                                               failed.load(std::memory_order_relaxed))) break;
+                if (predicate(data_table[i])) {
+                    is_one_satisfied = true;
+                    break;
+                }
+            }
 
-        // Funkce reprezentujici predikat 'predicate_index' poddotazu
-        auto &predicate = predicates[predicate_index];
+            if (is_one_satisfied) {
+                satisfied[predicate_index].store(true);
+                scheduler.skip_predicate(thread, predicate_index);
+            } else if (pending[predicate_index].fetch_sub(1) == 1 && !satisfied[predicate_index].load()) {
+                // Radek, pro ktery by predikat platil, neni v zadne dlazdici. Dotaz je nepravdivy.
+                failed.store(true);
+            }
+        }
+    }
 
-        //Kazdy radek tabulky je reprezentovany jednim prvkem vektoru 'data_table'.
-        // Velikost vektoru tedy odpovida poctu zaznamu
-        unsigned int row_count = data_table.size();
+    return !failed.load();
+}
 
-        bool is_one_satisfied = false;
+template<typename row_t>
+bool is_satisfied_for_any(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table) {
+    // Doimplementujte telo funkce, ktera rozhodne, zda je ALESPON JEDEN dilci dotaz pravdivy.
+    // To znamena, ze mate zjistit, zda existuje alespon jeden predikat 'p' a jeden zaznam
+    // v tabulce 'r' takovy, ze p(r) vraci true.
 
+    // Stejne dlazdice jako u is_satisfied_for_all. Pri malo predikatech si je vlakna rozkradou
+    // po usecich radku, pri mnoha pracuje kazde na jinych predikatech. Prvni nalezeny radek
+    // zastavi vsechna vlakna.
+    const int threads = omp_get_max_threads();
+    tile_scheduler_t scheduler(predicates.size(), data_table.size(), threads);
+    std::atomic<bool> found(false);
+
+#pragma omp parallel num_threads(threads)
+    {
+        const int thread = omp_get_thread_num();
+        size_t tile;
+
+        while (!found.load(std::memory_order_relaxed) && scheduler.next(thread, tile)) {
+            auto &predicate = predicates[scheduler.predicate_of(tile)];
+            const size_t begin = scheduler.first_row_of(tile);
+            const size_t end = std::min(begin + scheduler.tile_rows(), data_table.size());
+
+            for (size_t i = begin; i < end; i++) {
+                if ((i - begin) % 32 == 0 && found.load(std::memory_order_relaxed)) break;
+                if (predicate(data_table[i])) {
+                    found.store(true);
+                    break;
+                }
+            }
+        }
+    }
 
-        for (unsigned int i = 0; i < row_count; i++) {
-            // i-ty radek tabulky
-            auto &row = data_table[i];
+    return found.load();
+}
 
-            // splnuje 'predicate_index' predikat, pokud funkce predicate vrati true
-            bool is_satisfied = predicate(row);
+// Spolecne telo asynchronnich dotazu. Dlazdice rozdeluje tile_scheduler_t jako u predikatu
+// std::function, vlakno ale cte z vice dlazdic soucasne. Kazda dlazdice ma okno rozpracovanych
+// radku, ktere zacina na jednom a po kazdem kole bez nalezu se zdvojnasobi, takze casto splneny
+// predikat nezada zbytecne stovky cteni. Volna mista do 'depth' se doplnuji z dalsich dlazdic.
+// Soubeh uvnitr predikatu zajistuje okno, dlazdice jsou proto velke (jen tolik, aby se mezi vlakna
+// dala rozdelit prace i pri malo predikatech). Male dlazdice by zaplnily 'depth' ctenim dalsich
+// useku teze predikatu drive, nez se o nem cokoliv vi.
+// Pri 'conjunction' se hleda nesplneny predikat (jako is_satisfied_for_all), jinak splneny radek.
+template<typename row_t>
+bool async_satisfied(async_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table, size_t depth,
+                     bool conjunction) {
+    if (data_table.size() == 0) return conjunction && predicates.empty();
+    depth = std::max<size_t>(depth, 1);
+
+    const int threads = omp_get_max_threads();
+    // Dlazdic na predikat tolik, aby jich celkem bylo alespon 4 na vlakno
+    const size_t predicate_count = std::max<size_t>(predicates.size(), 1);
+    const size_t chunks = (4 * static_cast<size_t>(threads) + predicate_count - 1) / predicate_count;
+    tile_scheduler_t scheduler(predicates.size(), data_table.size(), threads,
+                               (data_table.size() + chunks - 1) / chunks);
+    std::vector<std::atomic<bool>> satisfied(conjunction ? predicates.size() : 0);
+    std::vector<std::atomic<uint32_t>> pending(conjunction ? predicates.size() : 0);
+    for (size_t i = 0; i < satisfied.size(); i++) {
+        satisfied[i].store(false, std::memory_order_relaxed);
+        pending[i].store(static_cast<uint32_t>(scheduler.chunks()), std::memory_order_relaxed);
+    }
+    // Konjunkce: nalezen nesplneny predikat, disjunkce: nalezen splnujici radek
+    std::atomic<bool> decided(false);
+
+#pragma omp parallel num_threads(threads)
+    {
+        struct active_tile_t {
+            size_t predicate, next_row, end;
+            size_t outstanding, window;
+            bool hit;
+        };
+
+        const int thread = omp_get_thread_num();
+        completion_queue_t queue;
+        std::vector<active_tile_t> tiles;                 // Index dlazdice je znacka jejich pozadavku
+        std::vector<uint32_t> active, free_slots;
+        std::vector<completion_queue_t::completion_t> completed;
+        size_t in_flight = 0;
+        bool exhausted = false;
+
+        while (!decided.load(std::memory_order_relaxed)) {
+            // Doplneni oken otevrenych dlazdic. Dlazdice, kterou uz neni treba cist a nema
+            // rozpracovana cteni, se uzavre.
+            for (size_t k = 0; k < active.size();) {
+                const uint32_t slot = active[k];
+                active_tile_t &tile = tiles[slot];
+                const bool more = tile.next_row < tile.end && !tile.hit &&
+                                  !(conjunction && satisfied[tile.predicate].load(std::memory_order_relaxed));
+                if (!more && tile.outstanding == 0) {
+                    // Dlazdice dobehla bez nalezu, pro konjunkci to muze byt posledni sance predikatu
+                    if (conjunction && pending[tile.predicate].fetch_sub(1) == 1 &&
+                        !satisfied[tile.predicate].load()) decided.store(true);
+                    free_slots.push_back(slot);
+                    active[k] = active.back();
+                    active.pop_back();
+                    continue;
+                }
+                while (more && in_flight < depth && tile.outstanding < tile.window && tile.next_row < tile.end) {
+                    predicates[tile.predicate].submit(data_table[tile.next_row++], slot, queue);
+                    tile.outstanding++;
+                    in_flight++;
+                }
+                k++;
+            }
 
-            if (is_satisfied) {
-                // Nalezli jsme radek, pro ktery je predikat splneny. Dilci poddotaz tedy plati
-                is_one_satisfied = true;
-                break;
+            // Nove dlazdice, dokud je misto
+            size_t next;
+            while (in_flight < depth && !exhausted && scheduler.next(thread, next)) {
+                const size_t predicate_index = scheduler.predicate_of(next);
+                if (conjunction && satisfied[predicate_index].load(std::memory_order_relaxed)) {
+                    scheduler.skip_predicate(thread, predicate_index);
+                    continue;
+                }
+                const size_t begin = scheduler.first_row_of(next);
+                const active_tile_t tile = {predicate_index, begin + 1,
+                                            std::min(begin + scheduler.tile_rows(), data_table.size()), 1, 1, false};
+                uint32_t slot;
+                if (free_slots.empty()) {
+                    slot = static_cast<uint32_t>(tiles.size());
+                    tiles.push_back(tile);
+                } else {
+                    slot = free_slots.back();
+                    free_slots.pop_back();
+                    tiles[slot] = tile;
+                }
+                active.push_back(slot);
+                predicates[predicate_index].submit(data_table[begin], slot, queue);
+                in_flight++;
+            }
+            if (in_flight < depth) exhausted = true;
+
+            // Zadna rozpracovana cteni a zadne nove dlazdice - vlakno skoncilo
+            if (in_flight == 0) break;
+
+            completed.clear();
+            queue.wait(completed);
+            for (const completion_queue_t::completion_t &completion : completed) {
+                active_tile_t &tile = tiles[completion.tag];
+                tile.outstanding--;
+                in_flight--;
+                if (completion.result && !tile.hit) {
+                    tile.hit = true;
+                    if (conjunction) {
+                        satisfied[tile.predicate].store(true);
+                        scheduler.skip_predicate(thread, tile.predicate);
+                    } else {
+                        decided.store(true);
+                    }
+                }
+                if (tile.outstanding == 0) tile.window = std::min(2 * tile.window, depth);
             }
         }
+        // Rozpracovana cteni po rozhodnuti dotazu se zahodi spolu s frontou
+    }
+
+    return conjunction ? !decided.load() : decided.load();
+}
 
-        // Radek, pro ktery by 'predicate_index' predikat platil, jsme nenasli.
-        // Dilci dotaz je tedy nepravdivy.
-        if(!is_one_satisfied){
-            return_value = false;
-#pragma omp cancel for
+template<typename row_t>
+bool is_satisfied_for_all(async_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table, size_t depth) {
+    return async_satisfied(predicates, data_table, depth, true);
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(async_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table, size_t depth) {
+    return async_satisfied(predicates, data_table, depth, false);
+}
+
+// Po kolika nejvice radcich se vyhodnocuje zkompilovany predikat a kontroluje, zda uz neni vysledek znamy
+constexpr size_t COMPILED_CHUNK_ROWS = 4096;
+
+// Existuje radek, pro ktery predikat plati? Prestane hledat (a vrati false), jakmile je nastaven 'stop'.
+// Usek zacina jednim blokem a zdvojnasobuje se, casto splneny predikat tak nevyhodnocuje zbytecne
+// tisice radku. Do 'scanned' (pokud neni nullptr) zapise pocet prectenych radku vcetne nalezeneho.
+template<typename row_t>
+bool has_satisfying_row(const compiled_predicate_t<row_t> &predicate, table_view_t<row_t> data_table,
+                        const std::atomic<bool> &stop, size_t *scanned = nullptr) {
+    uint64_t bitmap[COMPILED_CHUNK_ROWS / 64];
+    const size_t row_count = data_table.size();
+    size_t begin = 0, chunk = columnar::BLOCK_ROWS;
+
+    while (begin < row_count && !stop.load(std::memory_order_relaxed)) {
+        const size_t count = std::min(chunk, row_count - begin);
+        predicate.select(data_table.data() + begin, count, bitmap);
+        for (size_t w = 0; w < (count + 63) / 64; w++) {
+            if (bitmap[w] != 0) {
+                if (scanned) *scanned = begin + 64 * w + __builtin_ctzll(bitmap[w]) + 1;
+                return true;
+            }
         }
+        begin += count;
+        chunk = std::min(2 * chunk, COMPILED_CHUNK_ROWS);
     }
-
-    return return_value;
+    if (scanned) *scanned = begin;
+    return false;
 }
 
+// Totez pro predikat jako std::function, 'stop' se kontroluje po kazdem bloku radku
 template<typename row_t>
-bool is_satisfied_for_any(std::vector<predicate_t<row_t>> predicates, std::vector<row_t> data_table) {
-    // Doimplementujte telo funkce, ktera rozhodne, zda je ALESPON JEDEN dilci dotaz pravdivy.
-    // To znamena, ze mate zjistit, zda existuje alespon jeden predikat 'p' a jeden zaznam
-    // v tabulce 'r' takovy, ze p(r) vraci true.
+bool has_satisfying_row(const predicate_t<row_t> &predicate, table_view_t<row_t> data_table,
+                        const std::atomic<bool> &stop, size_t *scanned = nullptr) {
+    const size_t row_count = data_table.size();
+    size_t i = 0;
+
+    for (; i < row_count; i++) {
+        if (i % columnar::BLOCK_ROWS == 0 && stop.load(std::memory_order_relaxed)) break;
+        if (predicate(data_table[i])) {
+            if (scanned) *scanned = i + 1;
+            return true;
+        }
+    }
+    if (scanned) *scanned = i;
+    return false;
+}
 
-    // Zamyslete se nad tim, pro ktery druh dotazu je vhodny jaky druh paralelizace. Vas
-    // kod optimalizujte na situaci, kdy si myslite, ze navratova hodnota funkce bude true.
-    // Je pro Vas dulezitejsi rychle najit splnujici radek pro jeden vybrany predikat, nebo
-    // je dulezitejsi zkouset najit takovy radek pro vice predikatu paralelne?
+// Existuje radek, pro ktery predikat plati? Z indexu staci projit serazene hodnoty z intervalu
+// predikatu, bez indexu se se zone mapou prectou jen bloky, ktere se s intervalem protinaji.
+template<typename row_t>
+bool has_satisfying_row(const compiled_predicate_t<row_t> &predicate, const table_indexes_t<row_t> &data_table,
+                        const std::atomic<bool> &stop) {
+    columnar::interval_t bounds;
+    if (!predicate.bounds(bounds)) return has_satisfying_row(predicate, data_table.table, stop);
+    if (bounds.empty()) return false;
+
+    // Casto splneny predikat najde radek uz v prvnim bloku tabulky, to je levnejsi nez hledani v indexu
+    const size_t head = std::min(columnar::BLOCK_ROWS, data_table.table.size());
+    if (head != 0) {
+        uint64_t word;
+        predicate.select(data_table.table.data(), head, &word);
+        if (word != 0) return true;
+    }
 
-    bool return_value = false;
+    if (!data_table.index.empty()) {
+        return has_satisfying_row(predicate, data_table.index.values_between(bounds.low, bounds.high), stop);
+    }
 
+    const zone_map_t<row_t> &zones = data_table.zone_map;
+    if (zones.empty()) return has_satisfying_row(predicate, data_table.table, stop);
+
+    uint64_t bitmap[zone_map_t<row_t>::ZONE_ROWS / 64];
+    for (size_t zone = 0; zone < zones.zones() && !stop.load(std::memory_order_relaxed); zone++) {
+        if (!bounds.overlaps(zones.min(zone), zones.max(zone))) continue;
+        const table_view_t<row_t> rows = data_table.table.slice(zone * zone_map_t<row_t>::ZONE_ROWS,
+                                                                zone_map_t<row_t>::ZONE_ROWS);
+        predicate.select(rows.data(), rows.size(), bitmap);
+        for (size_t w = 0; w < (rows.size() + 63) / 64; w++) {
+            if (bitmap[w] != 0) return true;
+        }
+    }
+    return false;
+}
 
-    for(int predicate_index = 0; !return_value && predicate_index < predicates.size(); predicate_index++) {
+// Spolecne telo pro tabulku bez indexu i s nimi ('source' je table_view_t nebo table_indexes_t)
+template<typename row_t, typename source_t>
+bool compiled_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, const source_t &source) {
+    // Vyhodnoceni jednoho predikatu nad blokem je levne, paralelizujeme proto pres predikaty
+    // a prvni nesplneny predikat zastavi ostatni vlakna.
+    std::atomic<bool> failed(false);
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int predicate_index = 0; predicate_index < static_cast<int>(predicates.size()); predicate_index++) {
+        if (failed.load(std::memory_order_relaxed)) continue;
+        if (!has_satisfying_row(predicates[predicate_index], source, failed)) failed.store(true);
+    }
 
-        // Funkce reprezentujici predikat 'predicate_index' poddotazu
-        auto &predicate = predicates[predicate_index];
+    return !failed.load();
+}
 
-        //Kazdy radek tabulky je reprezentovany jednim prvkem vektoru 'data_table'.
-        // Velikost vektoru tedy odpovida poctu zaznamu
-        unsigned int row_count = data_table.size();
+template<typename row_t, typename source_t>
+bool compiled_satisfied_for_any(compiled_predicates_view_t<row_t> predicates, const source_t &source) {
+    // Kazde vlakno prochazi tabulku pro jiny predikat, prvni nalezeny radek zastavi ostatni.
+    std::atomic<bool> found(false);
 
-#pragma omp parallel for
-        for (unsigned int i = 0; i < row_count; i++) {
-            // i-ty radek tabulky
-            auto &row = data_table[i];
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int predicate_index = 0; predicate_index < static_cast<int>(predicates.size()); predicate_index++) {
+        if (found.load(std::memory_order_relaxed)) continue;
+        if (has_satisfying_row(predicates[predicate_index], source, found)) found.store(true);
+    }
 
-            // splnuje 'predicate_index' predikat, pokud funkce predicate vrati true
-            bool is_satisfied = predicate(row);
+    return found.load();
+}
 
-#pragma omp cancellation point for
-            if (is_satisfied) {
-                // Nalezli jsme radek, pro ktery je predikat splneny. Dilci poddotaz tedy plati
-                return_value = true;
-#pragma omp cancel for
-            }
-        }
+// Spolecne telo konjunkci se statistikami. Predikaty se rozdavaji vlaknum po jednom v poradi podle
+// statistik, takze pravdepodobne neplatne predikaty se vyhodnoti hned na zacatku.
+template<typename row_t, typename predicate_type>
+bool adaptive_satisfied_for_all(span_t<const predicate_type> predicates, table_view_t<row_t> data_table,
+                                query_statistics_t &statistics) {
+    using clock = std::chrono::steady_clock;
+
+    statistics.resize(predicates.size());
+    const std::vector<uint32_t> order = statistics.conjunction_order(data_table.size());
+    std::atomic<bool> failed(false);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int position = 0; position < static_cast<int>(order.size()); position++) {
+        if (failed.load(std::memory_order_relaxed)) continue;
+        const uint32_t predicate_index = order[position];
+
+        const bool timed = statistics.should_time(predicate_index);
+        const clock::time_point begin = timed ? clock::now() : clock::time_point();
+        size_t scanned = 0;
+        const bool satisfied = has_satisfying_row(predicates[predicate_index], data_table, failed, &scanned);
+
+        // Hledani prerusene jinym vlaknem o predikatu nic nerika
+        if (!satisfied && scanned < data_table.size()) continue;
+
+        const double seconds = timed ? std::chrono::duration<double>(clock::now() - begin).count() : -1.0;
+        statistics.record(predicate_index, satisfied, scanned, seconds);
+        if (!satisfied) failed.store(true);
     }
 
-    return return_value;
+    return !failed.load();
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(predicates_view_t<row_t> predicates, table_view_t<row_t> data_table,
+                          query_statistics_t &statistics) {
+    return adaptive_satisfied_for_all(predicates, data_table, statistics);
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table) {
+    return compiled_satisfied_for_all(predicates, data_table);
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table,
+                          query_statistics_t &statistics) {
+    return adaptive_satisfied_for_all(predicates, data_table, statistics);
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(compiled_predicates_view_t<row_t> predicates, table_view_t<row_t> data_table) {
+    return compiled_satisfied_for_any(predicates, data_table);
+}
+
+template<typename row_t>
+bool is_satisfied_for_all(compiled_predicates_view_t<row_t> predicates, const table_indexes_t<row_t> &data_table) {
+    return compiled_satisfied_for_all(predicates, data_table);
+}
+
+template<typename row_t>
+bool is_satisfied_for_any(compiled_predicates_view_t<row_t> predicates, const table_indexes_t<row_t> &data_table) {
+    return compiled_satisfied_for_any(predicates, data_table);
 }
 
 
@@ -0,0 +1,88 @@
+#ifndef CODE_CACHE_MISSES_H
+#define CODE_CACHE_MISSES_H
+
+#include <vector>
+#include <omp.h>
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// Trida CacheMissCounter pocita vypadky posledni urovne cache (hardwarovy citac PERF_COUNT_HW_CACHE_MISSES, jen
+// v uzivatelskem rezimu) ve vsech vlaknech OpenMP. citac se otevira v kazdem vlakne zvlast - vlakna OpenMP uz bezi
+// a citac se dedi jen do nove vytvorenych vlaken. bez citacu (jiny system nez Linux, virtualni stroj bez PMU,
+// zakazane perf_event_paranoid) vraci stop() -1
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        bool failed = false;
+#pragma omp parallel
+        {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            const int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#pragma omp critical
+            {
+                if (descriptor < 0) failed = true;
+                else descriptors.push_back(descriptor);
+            }
+        }
+        if (failed) close_all();
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    ~CacheMissCounter() {
+        close_all();
+    }
+
+    // vynuluje a spusti citace
+    void start() {
+#ifdef __linux__
+        for (int descriptor : descriptors) {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // zastavi citace a vrati soucet vypadku od start(), -1 pokud citace nejsou k dispozici
+    long long stop() {
+        if (descriptors.empty()) return -1;
+        long long total = 0;
+#ifdef __linux__
+        for (int descriptor : descriptors) {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            long long misses = 0;
+            if (read(descriptor, &misses, sizeof(misses)) != sizeof(misses)) return -1;
+            total += misses;
+        }
+#endif
+        return total;
+    }
+
+private:
+    std::vector<int> descriptors;
+
+    void close_all() {
+#ifdef __linux__
+        for (int descriptor : descriptors) close(descriptor);
+#endif
+        descriptors.clear();
+    }
+};
+
+#endif //CODE_CACHE_MISSES_H
@@ -6,6 +6,7 @@
 #include "_generator/generator.h"
 #include "sort.h"
 #include "_tests/test.h"
+#include "_tests/cache_misses.h"
 
 // nase prvky, ktere budeme radit, jsou retezce
 using element_t = std::string;
@@ -53,6 +54,60 @@ std::vector<element_t> sample_elements_from_distribution(const unsigned long cou
     return strings;
 }
 
+// dalsi datove sady pro obecne razeni retezcu (string_sort). jsou mensi, retezce jsou delsi
+const int count_of_general_elements = 5000000;
+// retezce promenne delky maji 0 az tolik znaku
+const int max_variable_length = 32;
+// retezce se spolecnymi prefixy vybiraji prefix z tolika moznosti
+const int count_of_prefixes = 16;
+
+// retezce promenne delky z libovolnych bytu (vcetne nuly a znaku nad 127)
+template<typename element_t>
+std::vector<element_t> sample_variable_length_elements(const unsigned long count_of_elements) {
+
+    std::uniform_int_distribution<int> length_dis(0, max_variable_length);
+    std::uniform_int_distribution<int> byte_dis(0, 255);
+    std::vector<element_t> strings(count_of_elements);
+    for (unsigned i = 0; i < count_of_elements; ++i) {
+        std::string str(length_dis(rng), '\0');
+        for (char &character : str) {
+            character = static_cast<char>(byte_dis(rng));
+        }
+        strings[i] = str;
+    }
+    return strings;
+}
+
+// retezce s dlouhymi spolecnymi prefixy (napr. URL z nekolika malo domen). prefix se vybira nerovnomerne - prvni
+// zacina polovina retezcu, druhy ctvrtina atd. - za nim nasleduje kratka nahodna pripona
+template<typename element_t>
+std::vector<element_t> sample_skewed_prefix_elements(const unsigned long count_of_elements) {
+
+    const std::string characters = "abcdefghijklmnopqrstuvwxyz0123456789/.";
+    std::uniform_int_distribution<unsigned long> character_dis(0, characters.size() - 1);
+    std::uniform_int_distribution<int> prefix_length_dis(24, 48);
+    std::uniform_int_distribution<int> suffix_length_dis(0, 12);
+    std::geometric_distribution<int> prefix_dis(0.5);
+
+    std::vector<std::string> prefixes(count_of_prefixes);
+    for (std::string &prefix : prefixes) {
+        prefix = "https://";
+        for (int j = prefix_length_dis(rng); j > 0; --j) {
+            prefix.push_back(characters.at(character_dis(rng)));
+        }
+    }
+
+    std::vector<element_t> strings(count_of_elements);
+    for (unsigned i = 0; i < count_of_elements; ++i) {
+        std::string str = prefixes[std::min(prefix_dis(rng), count_of_prefixes - 1)];
+        for (int j = suffix_length_dis(rng); j > 0; --j) {
+            str.push_back(characters.at(character_dis(rng)));
+        }
+        strings[i] = str;
+    }
+    return strings;
+}
+
 // instance radiciho algoritmu - instance vasho radiciho algoritmu
 // volani implementace vaseho radiciho algoritmu. vsimnete si, ze promena je funkce, kterou inicializujeme lambdou.
 // lambda ma jako vstup vektor odkazu na retezce, ktere maji byt serazeny. do vaseho radiciho algoritmu je vlozen tento
@@ -65,6 +120,20 @@ SortingAlgorithm<element_t> radix_sort = [](std::vector<element_t *> &vector_to_
     radix_par(vector_to_sort, Alphabet::get_bucket, Alphabet::alphabet_size, max_length);
 };
 
+// instance radiciho algoritmu
+// radix sort nad retezci zakodovanymi do cisel. viz "radix_packed" v souboru "sort.h"
+template<typename element_t>
+SortingAlgorithm<element_t> packed_radix_sort = [](std::vector<element_t *> &vector_to_sort) {
+    radix_packed(vector_to_sort, Alphabet::get_bucket, Alphabet::alphabet_size, max_length);
+};
+
+// instance radiciho algoritmu
+// MSD radix sort bez pomocnych bucketu. viz "radix_inplace" v souboru "sort.h"
+template<typename element_t>
+SortingAlgorithm<element_t> inplace_radix_sort = [](std::vector<element_t *> &vector_to_sort) {
+    radix_inplace(vector_to_sort, Alphabet::get_bucket, Alphabet::alphabet_size, max_length);
+};
+
 // instance radiciho algoritmu
 // pouziti radiciho algoritmu ze standardni knihovny
 template<typename element_t>
@@ -76,8 +145,9 @@ SortingAlgorithm<element_t> std_sort = [](std::vector<element_t *> &vector_to_so
     });
 };
 
-// evaluacni skript. v prvnim kroku preda data vasemu algoritmu. algoritmus spusti a zmeri cas.
-// pokud vas algoritmus retezce spravne seradil, vypise cas. v opacnem pripade evaluace vypise chybovou hlasku
+// evaluacni skript. v prvnim kroku preda data vasemu algoritmu. algoritmus spusti a zmeri cas a vypadky cache.
+// pokud vas algoritmus retezce spravne seradil, vypise cas a pocet vypadku (n/a, pokud je system neumi zmerit). v opacnem
+// pripade evaluace vypise chybovou hlasku
 template<typename element_t>
 void
 eval(const std::string &test_name, SortingAlgorithm<element_t> sorting_algorithm,
@@ -86,20 +156,25 @@ eval(const std::string &test_name, SortingAlgorithm<element_t> sorting_algorithm
 
     // Nejprve si vytvorime instanci testu
     SortingTest<element_t> sortingTest{data_to_sort, sorting_algorithm};
+    CacheMissCounter cacheMissCounter;
 
     try {
         // Cas zacatku behu testu
         auto begin = steady_clock::now();
+        cacheMissCounter.start();
         // Beh testu
         sortingTest.run_sort();
         // Konec behu testu
+        const long long cache_misses = cacheMissCounter.stop();
         auto end = steady_clock::now();
 
         // Kontrola spravnosti vysledku
         if (!sortingTest.verify(data_to_sort)) {
             printf("%s       --- wrong result ---\n", test_name.c_str());
         } else {
-            printf("%s          %7lldms\n", test_name.c_str(), duration_cast<milliseconds>(end - begin).count());
+            const std::string misses = cache_misses < 0 ? "n/a" : std::to_string(cache_misses);
+            printf("%s          %7lldms   %12s cache misses\n", test_name.c_str(),
+                   duration_cast<milliseconds>(end - begin).count(), misses.c_str());
         }
     } catch (...) {
         printf("%s      --- not implemented ---\n", test_name.c_str());
@@ -120,9 +195,39 @@ int main() {
     // spusti evaluaci vaseho radiciho algoritmu s vygenerovanymi daty. informace se zadanim viz "sort.h"
     eval<element_t>("student's radix sort", radix_sort<element_t>, data_to_sort);
 
+    // radix sort nad zakodovanymi klici
+    eval<element_t>("packed LSD radix sort", packed_radix_sort<element_t>, data_to_sort);
+
+    // MSD radix sort s presuny primo v razenem vektoru
+    eval<element_t>("in-place MSD radix sort", inplace_radix_sort<element_t>, data_to_sort);
+
+    // obecne razeni retezcu. string_sort ma presne tvar SortingAlgorithm, takze se preda primo
+    eval<element_t>("multikey quicksort", string_sort, data_to_sort);
+
+    // razeni podle prefixu ulozenych v souvislem poli, retezce se ctou jen pro shodne prefixy
+    eval<element_t>("prefix-cached radix sort", prefix_sort, data_to_sort);
+
     // razeni za pouziti std::sort. na vygenerovane datove sade by mel byt znatelne pomalejsi nez vase reseni. radek
     // pro urychleni testovani muzete zakomentovat
     eval<element_t>("std::sort", std_sort<element_t>, data_to_sort);
 
+    // retezce promenne delky z libovolnych bytu a retezce se spolecnymi prefixy. radix sorty vyse predpokladaji
+    // stejnou delku a abecedu "ABCDE", takze se na techto datech porovnava jen se std::sort
+    data_to_sort.clear();
+    data_to_sort.shrink_to_fit();
+    std::vector<element_t> variable_data = generate_data(count_of_general_elements,
+                                                         sample_variable_length_elements<element_t>);
+    eval<element_t>("multikey quicksort (variable lengths)", string_sort, variable_data);
+    eval<element_t>("prefix-cached radix sort (variable lengths)", prefix_sort, variable_data);
+    eval<element_t>("std::sort (variable lengths)", std_sort<element_t>, variable_data);
+    variable_data.clear();
+    variable_data.shrink_to_fit();
+
+    std::vector<element_t> skewed_data = generate_data(count_of_general_elements,
+                                                       sample_skewed_prefix_elements<element_t>);
+    eval<element_t>("multikey quicksort (skewed prefixes)", string_sort, skewed_data);
+    eval<element_t>("prefix-cached radix sort (skewed prefixes)", prefix_sort, skewed_data);
+    eval<element_t>("std::sort (skewed prefixes)", std_sort<element_t>, skewed_data);
+
     return 0;
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "sort.h"
 #include <iostream>
+#include <memory>
+#include <cstdint>
+#include <limits>
+#include <omp.h>
 
 void radix_ompv(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
                 unsigned long alphabet_size, unsigned long string_lengths, int current_index);
@@ -60,4 +64,387 @@ void radix_ompv(std::vector<std::string *> &vector_to_sort, const MappingFunctio
             vts_index++;
         }
     }
+}
+
+template<typename key_t>
+void radix_packed_keys(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
+                       unsigned long alphabet_size, unsigned long string_lengths, unsigned long long max_key) {
+    const size_t count = vector_to_sort.size();
+
+    // klice a pointery v oddelenych polich (klic ma jen 2-8 bytu). pole se nenuluji, prvni zapis je paralelni
+    std::unique_ptr<key_t[]> keys(new key_t[count]), keys_buffer(new key_t[count]);
+    std::unique_ptr<std::string *[]> pointers_buffer(new std::string *[count]);
+
+    // zakodovani retezcu
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < count; i++) {
+        const std::string &string = *vector_to_sort[i];
+        key_t key = 0;
+        for (unsigned long j = 0; j < string_lengths; j++) {
+            key = static_cast<key_t>(key * alphabet_size + mappingFunction(string[j]));
+        }
+        keys[i] = key;
+    }
+
+    // klic do 16 bitu se seradi jedinym pruchodem s cislici pres cely klic, delsi klice po bytech
+    int key_bits = 0;
+    for (unsigned long long rest = max_key; rest != 0; rest >>= 1) key_bits++;
+    const int digit_bits = key_bits <= 16 ? key_bits : 8;
+    const int passes = (key_bits + digit_bits - 1) / digit_bits;
+    const size_t digits = size_t(1) << digit_bits;
+
+    const int max_threads = omp_get_max_threads();
+    std::vector<std::vector<size_t>> histograms(max_threads, std::vector<size_t>(digits));
+
+#pragma omp parallel num_threads(max_threads)
+    {
+        const int threads = omp_get_num_threads(), thread = omp_get_thread_num();
+        const size_t begin = count * thread / threads, end = count * (thread + 1) / threads;
+        key_t *keys_from = keys.get(), *keys_to = keys_buffer.get();
+        std::string **from = vector_to_sort.data(), **to = pointers_buffer.get();
+
+        for (int pass = 0; pass < passes; pass++) {
+            const int shift = digit_bits * pass;
+            const key_t mask = static_cast<key_t>(digits - 1);
+            std::vector<size_t> &histogram = histograms[thread];
+            std::fill(histogram.begin(), histogram.end(), 0);
+            for (size_t i = begin; i < end; i++) histogram[(keys_from[i] >> shift) & mask]++;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                // pozice: nejdriv podle cislice, u stejne cislice podle vlakna (razeni zustane stabilni)
+                size_t position = 0;
+                for (size_t digit = 0; digit < digits; digit++) {
+                    for (int t = 0; t < threads; t++) {
+                        const size_t digit_count = histograms[t][digit];
+                        histograms[t][digit] = position;
+                        position += digit_count;
+                    }
+                }
+            }
+
+            // posledni pruchod uz klice nepresouva
+            const bool last = pass + 1 == passes;
+            for (size_t i = begin; i < end; i++) {
+                const size_t target = histogram[(keys_from[i] >> shift) & mask]++;
+                to[target] = from[i];
+                if (!last) keys_to[target] = keys_from[i];
+            }
+#pragma omp barrier
+            std::swap(keys_from, keys_to);
+            std::swap(from, to);
+        }
+
+        // po lichem poctu pruchodu jsou serazene pointery v pomocnem poli
+        if (from != vector_to_sort.data()) std::copy(from + begin, from + end, vector_to_sort.data() + begin);
+    }
+}
+
+void radix_packed(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
+                  unsigned long alphabet_size, unsigned long string_lengths) {
+    // pri jednom znaku v abecede nebo prazdnych retezcich jsou si vsechny retezce rovny
+    if (alphabet_size <= 1 || string_lengths == 0) return;
+
+    // nejvetsi klic je alphabet_size^string_lengths - 1, hlidame preteceni 64 bitu
+    unsigned long long max_key = 1;
+    for (unsigned long j = 0; j < string_lengths; j++) {
+        if (alphabet_size != 0 && max_key > std::numeric_limits<unsigned long long>::max() / alphabet_size) {
+            radix_par(vector_to_sort, mappingFunction, alphabet_size, string_lengths);
+            return;
+        }
+        max_key *= alphabet_size;
+    }
+    max_key -= 1;
+
+    if (max_key <= std::numeric_limits<uint16_t>::max()) {
+        radix_packed_keys<uint16_t>(vector_to_sort, mappingFunction, alphabet_size, string_lengths, max_key);
+    } else if (max_key <= std::numeric_limits<uint32_t>::max()) {
+        radix_packed_keys<uint32_t>(vector_to_sort, mappingFunction, alphabet_size, string_lengths, max_key);
+    } else {
+        radix_packed_keys<uint64_t>(vector_to_sort, mappingFunction, alphabet_size, string_lengths, max_key);
+    }
+}
+
+// bucket mensi nez tento limit se radi insertion sortem
+const size_t RADIX_INSERTION_CUTOFF = 32;
+// bucket vetsi nez tento limit se radi jako samostatny task
+const size_t RADIX_TASK_CUTOFF = 16384;
+
+// radi retezce first[0..count), ktere maji shodnych prvnich 'depth' znaku. digits[0..count) je misto pro znaky
+// retezcu na pozici 'depth' - kazdy retezec se tak na urovni cte jen jednou a vymeny po cyklech uz pracuji jen s polem
+// znaku. bez nej by kazda vymena cekala na nacteni retezce z nahodneho mista pameti.
+void american_flag(std::string **first, uint8_t *digits, size_t count, const MappingFunction &mappingFunction,
+                   unsigned long alphabet_size, unsigned long string_lengths, unsigned long depth) {
+    if (depth >= string_lengths || count <= 1) return;
+
+    if (count < RADIX_INSERTION_CUTOFF) {
+        // porovnani od znaku 'depth' podle poradi v abecede
+        auto less = [&](const std::string *a, const std::string *b) {
+            for (unsigned long j = depth; j < string_lengths; j++) {
+                const unsigned long x = mappingFunction((*a)[j]), y = mappingFunction((*b)[j]);
+                if (x != y) return x < y;
+            }
+            return false;
+        };
+        for (size_t i = 1; i < count; i++) {
+            std::string *value = first[i];
+            size_t j = i;
+            for (; j > 0 && less(value, first[j - 1]); j--) first[j] = first[j - 1];
+            first[j] = value;
+        }
+        return;
+    }
+
+    // velikosti bucketu a z nich zacatky (heads) a konce (tails) bucketu
+    std::vector<size_t> heads(alphabet_size, 0), tails(alphabet_size);
+    for (size_t i = 0; i < count; i++) {
+        digits[i] = static_cast<uint8_t>(mappingFunction((*first[i])[depth]));
+        heads[digits[i]]++;
+    }
+    size_t position = 0;
+    for (unsigned long bucket = 0; bucket < alphabet_size; bucket++) {
+        const size_t size = heads[bucket];
+        heads[bucket] = position;
+        position += size;
+        tails[bucket] = position;
+    }
+    const std::vector<size_t> starts(heads);
+
+    // vymeny po cyklech: heads[b] je prvni misto bucketu b, kde jeste nemusi byt jeho prvek
+    for (unsigned long bucket = 0; bucket < alphabet_size; bucket++) {
+        while (heads[bucket] < tails[bucket]) {
+            std::string *value = first[heads[bucket]];
+            uint8_t target = digits[heads[bucket]];
+            while (target != bucket) {
+                const size_t slot = heads[target]++;
+                std::swap(value, first[slot]);
+                std::swap(target, digits[slot]);
+            }
+            digits[heads[bucket]] = target;
+            first[heads[bucket]++] = value;
+        }
+    }
+
+    for (unsigned long bucket = 0; bucket < alphabet_size; bucket++) {
+        std::string **bucket_first = first + starts[bucket];
+        uint8_t *bucket_digits = digits + starts[bucket];
+        const size_t bucket_count = tails[bucket] - starts[bucket];
+        if (bucket_count > RADIX_TASK_CUTOFF) {
+#pragma omp task firstprivate(bucket_first, bucket_digits, bucket_count)
+            american_flag(bucket_first, bucket_digits, bucket_count, mappingFunction, alphabet_size, string_lengths,
+                          depth + 1);
+        } else {
+            american_flag(bucket_first, bucket_digits, bucket_count, mappingFunction, alphabet_size, string_lengths,
+                          depth + 1);
+        }
+    }
+}
+
+void radix_inplace(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
+                   unsigned long alphabet_size, unsigned long string_lengths) {
+    // znaky se ukladaji do bytu
+    if (alphabet_size > 256) {
+        radix_par(vector_to_sort, mappingFunction, alphabet_size, string_lengths);
+        return;
+    }
+    std::unique_ptr<uint8_t[]> digits(new uint8_t[vector_to_sort.size()]);
+
+    // tasky se dokonci nejpozdeji na bariere na konci paralelni oblasti
+#pragma omp parallel
+#pragma omp single
+    american_flag(vector_to_sort.data(), digits.get(), vector_to_sort.size(), mappingFunction, alphabet_size,
+                  string_lengths, 0);
+}
+
+// cast mensi nez tento limit se radi insertion sortem
+const size_t STRING_INSERTION_CUTOFF = 16;
+// cast vetsi nez tento limit se radi jako samostatny task
+const size_t STRING_TASK_CUTOFF = 16384;
+
+// znak retezce na pozici 'depth' jako 1 az 256, za koncem retezce 0 (kratsi retezec je mensi)
+inline int string_key(const std::string *string, size_t depth) {
+    return depth < string->size() ? static_cast<unsigned char>((*string)[depth]) + 1 : 0;
+}
+
+// delka nejdelsiho spolecneho prefixu vsech retezcu first[0..count) od pozice 'depth'
+size_t common_prefix(std::string **first, size_t count, size_t depth) {
+    const std::string &reference = *first[0];
+    size_t length = reference.size() - depth;
+    for (size_t i = 1; i < count && length > 0; i++) {
+        const std::string &string = *first[i];
+        size_t j = 0;
+        const size_t limit = std::min(length, string.size() - depth);
+        while (j < limit && string[depth + j] == reference[depth + j]) j++;
+        length = j;
+    }
+    return length;
+}
+
+// radi retezce first[0..count), ktere maji shodnych prvnich 'depth' znaku (vsechny jsou tedy alespon tak dlouhe)
+void multikey_quicksort(std::string **first, size_t count, size_t depth) {
+    while (count >= STRING_INSERTION_CUTOFF) {
+        // pivot je median znaku prvniho, prostredniho a posledniho retezce
+        int a = string_key(first[0], depth), b = string_key(first[count / 2], depth), c = string_key(first[count - 1], depth);
+        if (a > b) std::swap(a, b);
+        if (b > c) std::swap(b, c);
+        if (a > b) std::swap(a, b);
+        const int pivot = b;
+
+        // rozdeleni na tri casti: [0, less) < pivot, [less, greater) == pivot, [greater, count) > pivot
+        size_t less = 0, i = 0, greater = count;
+        while (i < greater) {
+            const int key = string_key(first[i], depth);
+            if (key < pivot) std::swap(first[less++], first[i++]);
+            else if (key > pivot) std::swap(first[i], first[--greater]);
+            else i++;
+        }
+
+        if (less > STRING_TASK_CUTOFF) {
+#pragma omp task firstprivate(first, less, depth)
+            multikey_quicksort(first, less, depth);
+        } else {
+            multikey_quicksort(first, less, depth);
+        }
+
+        // vsechny retezce maji na teto pozici stejny znak. misto dalsiho pruchodu po jednom znaku (napr. u dlouhych
+        // spolecnych prefixu) se preskoci cely spolecny prefix
+        if (less == 0 && greater == count) {
+            if (pivot == 0) return;
+            depth += 1 + common_prefix(first, count, depth + 1);
+            continue;
+        }
+
+        // retezce, ktere v teto pozici skoncily, jsou si rovny
+        if (pivot != 0) {
+            std::string **equal_first = first + less;
+            const size_t equal_count = greater - less;
+            if (equal_count > STRING_TASK_CUTOFF) {
+#pragma omp task firstprivate(equal_first, equal_count, depth)
+                multikey_quicksort(equal_first, equal_count, depth + 1);
+            } else {
+                multikey_quicksort(equal_first, equal_count, depth + 1);
+            }
+        }
+
+        // vetsi cast ve stejnem volani, aby rekurze nerostla se spatnymi pivoty
+        first += greater;
+        count -= greater;
+    }
+
+    for (size_t i = 1; i < count; i++) {
+        std::string *value = first[i];
+        size_t j = i;
+        for (; j > 0 && value->compare(depth, std::string::npos, *first[j - 1], depth, std::string::npos) < 0; j--) {
+            first[j] = first[j - 1];
+        }
+        first[j] = value;
+    }
+}
+
+void string_sort(std::vector<std::string *> &vector_to_sort) {
+    // tasky se dokonci nejpozdeji na bariere na konci paralelni oblasti
+#pragma omp parallel
+#pragma omp single
+    multikey_quicksort(vector_to_sort.data(), vector_to_sort.size(), 0);
+}
+
+// pocet znaku retezce v klici zaznamu, nejnizsi byte klice je delka
+const size_t PREFIX_CHARACTERS = 7;
+// delka v klici u retezcu delsich nez PREFIX_CHARACTERS, jejich poradi klic neurcuje
+const uint64_t PREFIX_INCOMPLETE = PREFIX_CHARACTERS + 1;
+
+struct prefix_record {
+    uint64_t key;
+    std::string *string;
+};
+
+// klic: znaky 0..6 od nejvyssiho bytu (chybejici znaky jsou nuly), v nejnizsim bytu min(delka, 8). stejne klice
+// s delkou do 7 znamenaji stejne retezce. "AB" < "AB\0", protoze se lisi jen delkou
+inline uint64_t prefix_key(const std::string &string) {
+    const size_t length = std::min(string.size(), PREFIX_CHARACTERS);
+    uint64_t key = 0;
+    for (size_t j = 0; j < length; j++) key |= uint64_t(static_cast<unsigned char>(string[j])) << (8 * (7 - j));
+    return key | std::min<uint64_t>(string.size(), PREFIX_INCOMPLETE);
+}
+
+void prefix_sort(std::vector<std::string *> &vector_to_sort) {
+    const size_t count = vector_to_sort.size();
+    const size_t digits = 256;
+
+    std::unique_ptr<prefix_record[]> records(new prefix_record[count]), records_buffer(new prefix_record[count]);
+
+    const int max_threads = omp_get_max_threads();
+    std::vector<std::vector<size_t>> histograms(max_threads, std::vector<size_t>(digits));
+    bool skip_pass = false;
+
+#pragma omp parallel num_threads(max_threads)
+    {
+        const int threads = omp_get_num_threads(), thread = omp_get_thread_num();
+        const size_t begin = count * thread / threads, end = count * (thread + 1) / threads;
+
+        // jediny pruchod, ktery cte vsechny retezce
+        for (size_t i = begin; i < end; i++) {
+            records[i].key = prefix_key(*vector_to_sort[i]);
+            records[i].string = vector_to_sort[i];
+        }
+
+        prefix_record *from = records.get(), *to = records_buffer.get();
+        for (int shift = 0; shift < 64; shift += 8) {
+            std::vector<size_t> &histogram = histograms[thread];
+            std::fill(histogram.begin(), histogram.end(), 0);
+            for (size_t i = begin; i < end; i++) histogram[(from[i].key >> shift) & 0xFF]++;
+
+#pragma omp barrier
+#pragma omp single
+            {
+                // byte, ktery maji vsechny klice stejny (napr. delka nebo chybejici znaky), poradi nemeni
+                skip_pass = false;
+                for (size_t digit = 0; digit < digits && !skip_pass; digit++) {
+                    size_t digit_count = 0;
+                    for (int t = 0; t < threads; t++) digit_count += histograms[t][digit];
+                    skip_pass = digit_count == count;
+                }
+
+                // pozice: nejdriv podle cislice, u stejne cislice podle vlakna (razeni zustane stabilni)
+                size_t position = 0;
+                for (size_t digit = 0; digit < digits; digit++) {
+                    for (int t = 0; t < threads; t++) {
+                        const size_t digit_count = histograms[t][digit];
+                        histograms[t][digit] = position;
+                        position += digit_count;
+                    }
+                }
+            }
+            if (skip_pass) continue;
+
+            for (size_t i = begin; i < end; i++) to[histogram[(from[i].key >> shift) & 0xFF]++] = from[i];
+#pragma omp barrier
+            std::swap(from, to);
+        }
+
+        for (size_t i = begin; i < end; i++) vector_to_sort[i] = from[i].string;
+#pragma omp barrier
+
+        // skupiny se stejnym klicem delsich retezcu se doradi od znaku, ktery uz v klici neni. klice jsou serazene,
+        // takze se staci podivat na souseda
+#pragma omp single
+        {
+            size_t run = 0;
+            for (size_t i = 1; i <= count; i++) {
+                if (i < count && from[i].key == from[run].key) continue;
+                if (i - run > 1 && (from[run].key & 0xFF) == PREFIX_INCOMPLETE) {
+                    std::string **first = vector_to_sort.data() + run;
+                    const size_t run_count = i - run;
+                    if (run_count > STRING_TASK_CUTOFF) {
+#pragma omp task firstprivate(first, run_count)
+                        multikey_quicksort(first, run_count, PREFIX_CHARACTERS);
+                    } else {
+                        multikey_quicksort(first, run_count, PREFIX_CHARACTERS);
+                    }
+                }
+                run = i;
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -31,4 +31,34 @@ using MappingFunction = const unsigned long (*)(const char &character_of_alphabe
 void radix_par(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
                unsigned long alphabet_size, unsigned long string_lengths);
 
+// radix sort pro retezce pevne delky nad malou abecedou. kazdy retezec se nejdriv (paralelne) zakoduje do jednoho
+// cisla - znaky jsou cislice v soustave o zakladu alphabet_size, takze poradi cisel odpovida lexikografickemu poradi
+// retezcu. podle nejvetsiho klice vybere nejmensi staci typ (16, 32 nebo 64 bitu) a klice spolu s pointery seradi
+// paralelnim LSD radix sortem (klic do 16 bitu jedinym pruchodem, delsi po bytech): kazde vlakno si spocita histogram
+// sve casti, z prefixovych souctu histogramu vsech vlaken vzniknou pozice a kazde vlakno svou cast rozmisti.
+// retezce se tak ctou jen jednou. pokud se klic nevejde do 64 bitu, pouzije radix_par.
+void radix_packed(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
+                  unsigned long alphabet_size, unsigned long string_lengths);
+
+// MSD radix sort bez pomocnych bucketu (American flag sort). na kazde urovni se spocitaji velikosti bucketu a pointery
+// se do nich presunou primo ve vector_to_sort vymenami po cyklech: prvek se vymeni na volne misto sveho bucketu
+// a prvek odtud pokracuje do sveho bucketu, dokud cyklus nedojde zpet. velke buckety se radi jako OpenMP tasky, male
+// (pod RADIX_INSERTION_CUTOFF) insertion sortem. pamet navic je O(alphabet_size) na uroven rekurze a jedno pole bytu
+// se znaky retezcu na aktualni pozici (sdilene vsemi urovnemi), zadne buckety se nealokuji ani nekopiruji.
+void radix_inplace(std::vector<std::string *> &vector_to_sort, const MappingFunction &mappingFunction,
+                   unsigned long alphabet_size, unsigned long string_lengths);
+
+// obecne razeni retezcu libovolne delky z libovolnych bytu (poradi jako std::string::operator<). pouziva multikey
+// quicksort: retezce se rozdeli podle znaku na aktualni pozici na mensi, stejne a vetsi nez pivot, mensi a vetsi se radi
+// dal podle teze pozice a stejne podle nasledujici. spolecne prefixy se tak porovnavaji jen jednou. velke casti se radi
+// jako OpenMP tasky, male (pod STRING_INSERTION_CUTOFF) insertion sortem. da se predat primo jako SortingAlgorithm.
+void string_sort(std::vector<std::string *> &vector_to_sort);
+
+// obecne razeni retezcu (stejne poradi jako string_sort) bez honeni pointeru. nejdriv se paralelne vytvori souvisle pole
+// zaznamu (klic, pointer), kde klic je prvnich 7 znaku retezce a v nejnizsim bytu jeho delka (nejvyse 8), takze poradi
+// klicu odpovida poradi retezcu. zaznamy se seradi paralelnim LSD radix sortem po bytech klice (pruchody, ve kterych
+// maji vsechny klice stejny byte, se preskoci). retezce se ctou znovu jen ve skupinach se stejnym klicem delsich nez
+// 7 znaku, ty se doradi od 8. znaku multikey quicksortem. da se predat primo jako SortingAlgorithm.
+void prefix_sort(std::vector<std::string *> &vector_to_sort);
+
 #endif //CODE_SORT_H
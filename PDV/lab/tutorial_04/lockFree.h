@@ -4,9 +4,23 @@
 #include <vector>
 #include <iostream>
 #include <atomic>
+#include <cstdint>
 
-class Lockfree {
+#include "reclamation.h"
+
+// Lock-free serazeny spojovy seznam (Harris, Michael). Mazani je dvoufazove:
+//   1) Prvek oznacim za smazany bitovym priznakem v ukazateli 'next'. Tim zabranim ostatnim
+//      vlaknum vkladat za nej nove prvky.
+//   2) Pote ho vypojim ze seznamu. Pokud se to nepovede, vypoji ho kterekoliv vlakno, ktere
+//      na nej pri hledani narazi.
+// Vypojene uzly se uvolnuji pres 'reclaimer_t' (reclamation::epoch nebo reclamation::hazard,
+// viz reclamation.h), hledani pouziva tri hazard sloty: 0 = next, 1 = current, 2 = predchudce.
+template <typename reclaimer_t>
+class LockfreeList {
 public:
+    typedef reclaimer_t reclaimer;
+    typedef typename reclaimer_t::guard guard;
+
     class Node {
     public:
         unsigned long long value;
@@ -17,47 +31,113 @@ public:
 
     Node* head = new Node(999999999999UL);
 
+    ~LockfreeList() {
+        // Volano az po skonceni vsech operaci, v seznamu uz nejsou oznacene uzly
+        Node* current = head;
+        while (current != nullptr) {
+            Node* next = unmarked(current->next.load());
+            delete current;
+            current = next;
+        }
+    }
+
     void insert(unsigned long long value) {
+        guard g = reclaimer::instance().pin();
+
         // 1. alokuju node
         Node* new_node = new Node(value);
 
-        Node* current = head;
         while (true) {
-            // prochazim linked list podobne jako u seriove varianty
-            Node* next = current->next;
-            if (next != nullptr && next->value <= value) {
-                // posouvam s k dalsimu nodu
-                current = current->next;
-            } else {
-                // nasel jsem spravne misto pro insert
-                // 2. nastavim ->next sveho nodu na `current->next`
-                new_node->next = next;
-                // 3. zkusim provest `current->next = new_node`, ale jen pokud je v momente
-                //  prirazeni porad `current->next == next`; pokud jsem uspel, mam hotovo;
-                //  potrebuji zopakovat cely loop od zacatku, protoze v pripade, ze ma nove pridany
-                //  node mensi hodnotu nez `value`, tak se musim posunout az za nej
-                if (current->next.compare_exchange_strong(next, new_node)) {
-                    break;
-                }
-                // jinak zkusim cely proces od aktualniho nodu zopakovat
+            // 2. najdu misto za vsemi prvky s hodnotou <= value
+            std::atomic<Node*>* prev;
+            Node* current;
+            find(value, false, g, prev, current);
+
+            // 3. zkusim provest `*prev = new_node`, ale jen pokud tam porad je `current` bez priznaku
+            new_node->next.store(current);
+            if (prev->compare_exchange_strong(current, new_node)) {
+                break;
             }
         }
     }
 
-    // Pokud byste si chteli vyzkouset slozitejsi operaci se spojovym seznamem, muzete
-    // si zkusit naimplementovat metodu pro odebrani prvku ze seznamu. Vzpomente si,
-    // ze na prednasce jsme si rikali, ze mazani prvku probiha dvoufazove.
-    //   1) Nejprve prvek oznacim za smazany. Tim zabranim ostatnim vlaknu vkladat za
-    //      nej nove prvky.
-    //   2) Pote ho vypojim ze seznamu
-    //
-    // Oznaceni prvku za smazany muzete provest pomoci atomickych operaci tak, ze ukazatel
-    // na naslednika oznacite bitovym priznakem (schematicky napr., current->next | 1ULL).
-    //
-    // Pro jednoduchost nemusite resit dealokaci pameti po odebrani prvku.
+    // Odebere jeden prvek s hodnotou 'value', vraci false, pokud v seznamu zadny neni
     bool remove(unsigned long long value) {
-        throw "Not implemented yet";
+        guard g = reclaimer::instance().pin();
+
+        while (true) {
+            std::atomic<Node*>* prev;
+            Node* current;
+            if (!find(value, true, g, prev, current)) return false;
+
+            // 1) oznacim prvek za smazany, pokud to nestihlo jine vlakno
+            Node* next = g.protect(0, current->next);
+            if (marked(next)) continue;
+            if (!current->next.compare_exchange_strong(next, with_mark(next))) continue;
+
+            // 2) vypojim ho, pri neuspechu ho vypoji find()
+            Node* expected = current;
+            if (prev->compare_exchange_strong(expected, next)) {
+                reclaimer::instance().retire(current);
+            } else {
+                find(value, true, g, prev, current);
+            }
+            return true;
+        }
+    }
+
+private:
+    static bool marked(Node* pointer) {
+        return (reinterpret_cast<uintptr_t>(pointer) & 1) != 0;
+    }
+
+    static Node* unmarked(Node* pointer) {
+        return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(pointer) & ~static_cast<uintptr_t>(1));
+    }
+
+    static Node* with_mark(Node* pointer) {
+        return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(pointer) | 1);
+    }
+
+    // Najde hranu 'prev' a prvni neoznaceny uzel 'current' s hodnotou >= value (inclusive)
+    // nebo > value. Oznacene uzly po ceste vypojuje. Vraci, zda ma 'current' hodnotu value.
+    bool find(unsigned long long value, bool inclusive, guard& g, std::atomic<Node*>*& prev, Node*& current) {
+        while (true) {
+            prev = &head->next;
+            current = g.protect(1, *prev);
+            bool restart = false;
+
+            while (!restart) {
+                if (current == nullptr) return false;
+
+                Node* next = g.protect(0, current->next);
+                // Predchudce se zmenil nebo byl oznacen, `next` uz nemusi byt platny
+                if (prev->load() != current) {
+                    restart = true;
+                } else if (!marked(next)) {
+                    if (inclusive ? current->value >= value : current->value > value) {
+                        return current->value == value;
+                    }
+                    prev = &current->next;
+                    g.publish(2, current);
+                    current = next;
+                    g.publish(1, current);
+                } else {
+                    Node* expected = current;
+                    if (prev->compare_exchange_strong(expected, unmarked(next))) {
+                        reclaimer::instance().retire(current);
+                        current = unmarked(next);
+                        g.publish(1, current);
+                    } else {
+                        restart = true;
+                    }
+                }
+            }
+        }
     }
 };
 
+typedef LockfreeList<reclamation::epoch> Lockfree;
+typedef LockfreeList<reclamation::hazard> LockfreeHazard;
+
 #endif
\ No newline at end of file
@@ -18,6 +18,10 @@ constexpr int N = 30000;
 // Pocet iteraci, po ktere budeme zkouset spravnost implementace mazani
 constexpr int M = 1000000;
 
+// Zatezovy test uvolnovani pameti: pocet dvojic vlozeni a odebrani a pocet prvku predplneneho seznamu
+constexpr int C = 400000;
+constexpr int K = 256;
+
 // Metoda, ktera zkontroluje, ze list obsahuje prvky 0..(elems-1) v serazenem poradi.
 // Tato metoda funguje na libovolnem listu, ktery ma vnitrni uzly reprezentovane tridou
 // 'Node', ktera obsahuje hodnotu v clenske promenne 'value' a ukazatel (neatomicky i
@@ -199,17 +203,48 @@ double evalRemove(std::string name, double ref_time) {
     return elapsed;
 }
 
+// Zatezovy test lock-free seznamu s danym zpusobem uvolnovani pameti. Seznam obsahuje prvky 0..K-1,
+// vlakna do nej C-krat vlozi a zase odeberou nahodny prvek. Vypisuje propustnost a nejvetsi
+// mnozstvi pameti vypojenych, ale jeste neuvolnenych uzlu.
+template <typename LLType>
+void evalChurn(std::string name) {
+    LLType ll;
+    for (int k = K - 1; k >= 0; k--) ll.insert(k);
+
+    auto & memory = LLType::reclaimer::instance().memory();
+    memory.reset_peak();
+
+    auto begin = steady_clock::now();
+#pragma omp parallel for schedule(static, 256)
+    for (int i = 0; i < C; i++) {
+        const unsigned long long value = (static_cast<unsigned long long>(i) * 2654435761ULL) % K;
+        ll.insert(value);
+        ll.remove(value);
+    }
+    auto end = steady_clock::now();
+
+    const long elapsed = static_cast<long>(duration_cast<microseconds>(end - begin).count());
+    printf("%s %9ldus (%6.3f Mops/s, peak retired %6lldkB)  result: %s\n", name.c_str(), elapsed,
+           2.0 * C / elapsed, memory.peak_bytes() / 1024, check(ll, K) ? "correct" : "incorrect");
+}
+
 int main() {
     // Spustime testy jednotlivych implementaci spojoveho seznamu:
     printf("INSERT:\n");
     double sequential_time = evalInsert<Sequential>("Sequential linked-list   ", -1);
     evalInsert<Concurrent>("Lock-based linked-list   ", sequential_time);
     evalInsert<Lockfree>("Lock-free linked-list    ", sequential_time);
+    evalInsert<LockfreeHazard>("Lock-free (hazard ptrs)  ", sequential_time);
 
     printf("\n\nINSERT & REMOVE:\n");
     sequential_time = evalRemove<Sequential>("Sequential linked-list   ", -1);
     evalRemove<Concurrent>("Lock-based linked-list   ", sequential_time);
     evalRemove<Lockfree>("Lock-free linked-list    ", sequential_time);
+    evalRemove<LockfreeHazard>("Lock-free (hazard ptrs)  ", sequential_time);
+
+    printf("\n\nMEMORY RECLAMATION:\n");
+    evalChurn<Lockfree>("Epoch-based reclamation  ");
+    evalChurn<LockfreeHazard>("Hazard pointers          ");
 
 
     printf("\n\n");